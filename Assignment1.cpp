@@ -3,7 +3,26 @@
 	using std::cin;
 	using std::endl;
 #include "BigInteger.h"
+#include "BigIntegerBatch.h"
+#include "BigIntegerAccumulator.h"
+#include "BigIntegerBulk.h"
+#include "P192Point.h"
+#include "BigIntegerReducer.h"
+#include "BigIntegerMontgomery.h"
+#include "BigIntegerView.h"
+#include "BigIntegerVar.h"
+#include "BigIntegerExpr.h"
+#include "BigIntegerStream.h"
+#include "BigIntegerStats.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
 
 //---------------------------------------------------------------
 /*
@@ -16,10 +35,17 @@ void printConstants()
     cout << "BIG0 = " << BIG0 << endl;
 	cout << "BIG1 = " << BIG1 << endl;
 
-	BigInteger big12345678(0x12345678);
+	BigInteger<> big12345678(0x12345678);
 	cout << "big12345678 = " << big12345678 << endl;
-	BigInteger big_string("000123456789abcDEF");
+	BigInteger<> big_string("000123456789abcDEF");
 	cout << "big_string = " << big_string << endl;
+
+	char buf[BigInteger<>::HEX_CHARS + 1];
+	*big_string.toHex(buf, false) = '\0';
+	cout << "big_string = " << buf << " (without leading zeros)" << endl;
+
+	constexpr BigInteger<> p192 = 0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFF_big;
+	cout << "p192 = " << p192 << " (compile-time literal)" << endl;
 }
 
 //---------------------------------------------------------------
@@ -32,18 +58,18 @@ void testAdd()
     cout << endl;
     
 	// Testing the addition algorithm
-	BigInteger big12345678(0x12345678);
+	BigInteger<> big12345678(0x12345678);
 	cout << "0x12345678 + 0x00000001 = " << big12345678.addc(BIG1) << endl;
 
-	BigInteger big_msb(0x80000000);
+	BigInteger<> big_msb(0x80000000);
 	cout << "0x80000000 + 0x80000000 = " << big_msb.addc(big_msb) << endl;
     
-    BigInteger big_anzi(0x12345678);
-	BigInteger big_max(0xFFFFFFFF);
+    BigInteger<> big_anzi(0x12345678);
+	BigInteger<> big_max(0xFFFFFFFF);
 	cout << "0xFFFFFFFF + 0x12345678 = " << big_max.adda(big_anzi) << endl;
 
-	BigInteger big_val1("A5F05A0FA5F05A0F");
-	BigInteger big_val2("5A0FA5F05A0FA5F1");
+	BigInteger<> big_val1("A5F05A0FA5F05A0F");
+	BigInteger<> big_val2("5A0FA5F05A0FA5F1");
 	cout << "A5F05A0FA5F05A0F + 5A0FA5F05A0FA5F1 = " << big_val1.addc(big_val2) << endl;
 }
 
@@ -69,19 +95,667 @@ void testModp192()
     cout << endl;
 	cout << "v1 = FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF4444444444444445678887543890789AB0CEFFFFFFFFFFFFFFFFFFFFFFF" << endl;
 	
-    BigInteger v1("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF4444444444444445678887543890789AB0CEFFFFFFFFFFFFFFFFFFFFFFF");
+    BigInteger<> v1("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF4444444444444445678887543890789AB0CEFFFFFFFFFFFFFFFFFFFFFFF");
 	cout << "v1 mod p192 = " << v1.modp192a() << endl;
+
+	BigInteger<> v2("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF4444444444444445678887543890789AB0CEFFFFFFFFFFFFFFFFFFFFFFF");
+	cout << "v1 mod p192 = " << v2.modp192() << " (dispatched)" << endl;
     
 }
 
+//---------------------------------------------------------------
+/*
+ * Some testcases to test the P-192 field multiplication
+ */
+void testMulmod192()
+{
+	cout << endl << "Running testMulmod192()" << endl;
+	cout << endl;
+
+	BigInteger<> a("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFE");	// p - 1
+	BigInteger<> b("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFE");
+	cout << "(p-1) * (p-1)        = " << a.mul192(b) << endl;
+	cout << "(p-1) * (p-1) mod p  = " << a.modp192a() << endl;
+
+	BigInteger<192> c("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFE");
+	cout << "(p-1)^2 mod p        = " << c.sqrmod192() << endl;
+
+	BigInteger<192> d("0123456789ABCDEFFEDCBA98765432100F1E2D3C4B5A6978");
+	BigInteger<192> e("A5F05A0FA5F05A0F5A0FA5F05A0FA5F1DEADBEEFCAFEBABE");
+	cout << "d * e mod p          = " << d.mulmod192(e) << endl;
+}
+
+//---------------------------------------------------------------
+/*
+ * Some testcases to test the P-192 field inversion
+ */
+void testInvmod192()
+{
+	cout << endl << "Running testInvmod192()" << endl;
+	cout << endl;
+
+	BigInteger<192> d("0123456789ABCDEFFEDCBA98765432100F1E2D3C4B5A6978");
+	BigInteger<192> inv = d, inv_gcd = d;
+	cout << "d^-1 mod p (Fermat)  = " << inv.invmod192() << endl;
+	cout << "d^-1 mod p (GCD)     = " << inv_gcd.invmod192gcd() << endl;
+	cout << "d * d^-1 mod p       = " << inv.mulmod192(d) << endl;
+
+	BigInteger<192> values[3] = {d, BigInteger<192>(2), BigInteger<192>("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFE")};
+	BigInteger<192>::invmod192Batch(values, 3);
+	cout << "batch: d^-1          = " << values[0] << endl;
+	cout << "batch: 2^-1          = " << values[1] << endl;
+	cout << "batch: (p-1)^-1      = " << values[2] << endl;
+}
+
+//---------------------------------------------------------------
+/*
+ * Some testcases to test the batch reduction against modp192c
+ */
+void testBatch()
+{
+	cout << endl << "Running testBatch()" << endl;
+	cout << endl;
+
+	const char *vectors[] = {
+		"bfb0ea3d5bf9cef301ea608e20ab8f6fe601f02123323d59ffffffff00000001ffffffff111111110000ffffffffffff",
+		"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+		"ffffffff11111111ffffffff11111111ffffffff11111111ffffffff11111111ffffffff11111111ffffffffffffffff",
+		"65e635321cb6aa3de6a9704125856bd5c46e4c531f0f3c420bd650e6a48e90b672f57708def13a9dc172d66da06783d9",
+		"eeeeeeeeffffffffeeeeeeeeffffffffeeeeeeeeffffffffeeeeeeeeffffffffeeeeeeeeffffffffeeeeeeeeffffffff",
+		"90a54935dbc97516efad8ae7de72a15290f44f19545dfcdbd5e058757b862406b05ac89c8075988ff5a302d3bfaf9665",
+		"ffffffffffffffffffffffffffffffffffffffffffffffff000000000000000000000000000000000000000000000000",
+		"f1111111f1111111f1111111f1111111f1111111f1111111f1111111f1111111f1111111f1111111f1111111f1111111",
+		"0fffffff0fffffff0fffffff0fffffff0fffffff0fffffff0fffffff0fffffff0fffffff0fffffff0fffffff0fffffff",
+		"9c96882ee787d2ffd1d5203b37ac0f93be00fc4cc384b000048720f98635133048f2dcb0ea813410ec470b15b6827bbf"
+	};
+	const int n = sizeof(vectors) / sizeof(vectors[0]);
+
+	BigIntegerBatch<> batch(n), expected(n);
+	for (int i=0; i<n; i++) {
+		BigInteger<> v(vectors[i]);
+		batch.set(i, v);
+		expected.set(i, v.addc(v).modp192c());
+	}
+	batch.addc(batch).modp192c();
+
+	bool equal[n];
+	cout << "2*v mod p192: " << std::dec << batch.compare(expected, equal) << " of " << n << " lanes match modp192c" << std::hex << endl;
+	cout << "lane 0 = " << batch.get(0) << endl;
+}
+
+//---------------------------------------------------------------
+/*
+ * Some testcases to test the lazy reduction of sums
+ */
+void testAccumulator()
+{
+	cout << endl << "Running testAccumulator()" << endl;
+	cout << endl;
+
+	BigInteger<192> term("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF");	// 2^192 - 1, not reduced
+	BigInteger<192> step(1);
+	BigIntegerAccumulator acc;
+	BigInteger<> expected;
+	for (int i=0; i<1000; i++) {
+		acc.add(term);
+		expected.add(BigInteger<>(term)).modp192();		// reduce after every addition
+		term.add(step);
+	}
+	BigInteger<192> sum = acc.result();
+	cout << "sum of 1000 terms mod p = " << sum << endl;
+	cout << "reduced every step      = " << BigInteger<192>(expected) << endl;
+}
+
+//---------------------------------------------------------------
+/*
+ * Some testcases to test the bulk reduction and its input checks
+ */
+void testBulk()
+{
+	cout << endl << "Running testBulk()" << endl;
+	cout << endl;
+
+	const std::string ones(96, 'F');
+	const std::string text = "// values\n12\n  fedcba9876543210 \r\n\n" + ones + "\nhello\n34\n";
+	FILE *out = tmpfile();
+	bigIntegerBulkStats stats;
+	errno = 0;
+	bool ok = bigIntegerBulkReduce(text.data(), text.size(), out, 2, &stats);
+	const bool invalid = errno == EINVAL;
+	std::string written(ftell(out), '\0');
+	rewind(out);
+	written.resize(fread(&written[0], 1, written.size(), out));
+	fclose(out);
+	cout << "stopped at \"hello\": " << (!ok && invalid && stats.invalidOffset == text.find("hello"))
+	     << ", values in front of it written: " << std::dec << stats.values << std::hex << endl;
+	cout << "last value written: " << written.substr(written.size() - 49);
+
+	// every line has to be a value of up to 96 hex digits
+	const std::string rejected[] = {"0x12", "hello", "1 2", "1" + std::string(96, '0'), "/", "12-"};
+	int count = 0;
+	out = tmpfile();
+	for (const std::string &line : rejected) {
+		errno = 0;
+		ok = bigIntegerBulkReduce(line.data(), line.size(), out, 1, &stats);
+		count += !ok && errno == EINVAL && stats.invalidOffset == 0 && stats.values == 0;
+	}
+	fclose(out);
+	cout << "invalid lines rejected: " << std::dec << count << " of 6" << std::hex << endl;
+}
+
+//---------------------------------------------------------------
+/*
+ * Some testcases to test the P-192 point arithmetic
+ */
+void testP192Point()
+{
+	cout << endl << "Running testP192Point()" << endl;
+	cout << endl;
+
+	BigInteger<192> x, y;
+	BigInteger<192> k("0123456789ABCDEFFEDCBA98765432100F1E2D3C4B5A6978");
+	P192Point q = P192Point::mulBase(k);
+	q.toAffine(x, y);
+	cout << "k * G (comb)  = (" << x << ", " << y << ")" << endl;
+
+	P192Point r = P192Point::generator();
+	r.mul(k);
+	r.toAffine(x, y);
+	cout << "k * G (wNAF)  = (" << x << ", " << y << ")" << endl;
+	cout << "on curve: " << q.isOnCurve() << ", equal: " << q.equals(r) << endl;
+
+	P192Point o = P192Point::generator();
+	cout << "n * G is infinity: " << o.mul(P192Point::order()).isInfinity() << endl;
+}
+
+/*
+ * Multi-scalar multiplication compared with the sum of single
+ * scalar multiplications
+ */
+void testMsm()
+{
+	cout << endl << "Running testMsm()" << endl;
+	cout << endl;
+
+	const size_t n = 50;
+	std::vector<P192Point> points(n);
+	std::vector<BigInteger<192> > scalars(n);
+	BigInteger<192> k("0123456789ABCDEFFEDCBA98765432100F1E2D3C4B5A6978");
+	BigInteger<192> step("FEDCBA98765432100123456789ABCDEF1122334455667788");
+	P192Point sum;
+	for (size_t i=0; i<n; i++) {
+		scalars[i] = k;
+		points[i] = P192Point::mulBase(step);
+		P192Point q = points[i];
+		sum.add(q.mul(k));
+		k.mulmod192(step);
+		step.addmod192(k);
+	}
+
+	P192Point single = P192Point::msm(&points[0], &scalars[0], n);
+	P192Point threaded = P192Point::msm(&points[0], &scalars[0], n, 4);
+	BigInteger<192> x, y;
+	single.toAffine(x, y);
+	cout << std::dec << n << " points, window " << P192Point::msmWindow(n) << std::hex << endl;
+	cout << "sum k_i * P_i = (" << x << ", " << y << ")" << endl;
+	cout << "equal to single multiplications: " << single.equals(sum)
+	     << ", 4 threads: " << threaded.equals(sum) << endl;
+}
+
+/*
+ * Reduction contexts: the Solinas schedule of P-192 against
+ * modp192(), the NIST primes P-224, P-256 and P-384, and Barrett
+ * reduction for a modulus of no special form
+ */
+void testReducer()
+{
+	cout << endl << "Running testReducer()" << endl;
+	cout << endl;
+
+	BigInteger<> x("FEDCBA98765432100123456789ABCDEF1122334455667788"
+	               "99AABBCCDDEEFF000F1E2D3C4B5A69788796A5B4C3D2E1F0");
+	BigIntegerReducer p192(BigInteger<192>("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFF"));
+	BigIntegerReducer other(BigInteger<192>("C0FFEE0123456789ABCDEF0123456789ABCDEF0123456789"));
+	BigInteger<> r, s;
+
+	r = x; s = x;
+	cout << "x mod p192 (solinas " << (p192.reduction() == BIG_INTEGER_REDUCTION_SOLINAS) << ") = "
+	     << p192.reduce(r) << ", equal to modp192: " << r.compare(s.modp192()) << endl;
+	r = x;
+	cout << "x mod P-224 = " << BigIntegerReducer::p224().reduce(r) << endl;
+	r = x;
+	cout << "x mod P-256 = " << BigIntegerReducer::p256().reduce(r) << endl;
+	r = x;
+	cout << "x mod P-384 = " << BigIntegerReducer::p384().reduce(r) << endl;
+	r = x;
+	cout << "x mod m (barrett " << (other.reduction() == BIG_INTEGER_REDUCTION_BARRETT) << ") = "
+	     << other.reduce(r) << endl;
+}
+
+/*
+ * Montgomery arithmetic: CIOS and FIOS products, Fermat's little
+ * theorem a^(p-1) = 1 mod p for the prime P-384 and a^e mod m for an
+ * odd modulus of no special form
+ */
+void testMontgomery()
+{
+	cout << endl << "Running testMontgomery()" << endl;
+	cout << endl;
+
+	BigInteger<> p384("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFE"
+	                  "FFFFFFFF0000000000000000FFFFFFFF");
+	BigInteger<> m("C0FFEE0123456789ABCDEF0123456789ABCDEF0123456789"
+	               "FEDCBA98765432100123456789ABCDEF1122334455667789");
+	BigInteger<> a("0123456789ABCDEFFEDCBA98765432100F1E2D3C4B5A6978");
+	BigInteger<> e("10001");
+	BigIntegerMontgomery<> prime(p384), odd(m);
+
+	// a * R times the normal a^2 gives the normal a^3
+	BigInteger<> x = a, y = a, b = a;
+	b.sqr192();
+	odd.toMontgomery(x);
+	odd.toMontgomery(y);
+	cout << "a^3 mod m (CIOS) = " << odd.mulCios(x, b) << endl;
+	cout << "a^3 mod m (FIOS) = " << odd.mulFios(y, b) << endl;
+
+	x = a;
+	cout << "a^10001 mod m    = " << odd.modexp(x, e) << endl;
+	x = a;
+	BigInteger<> pMinus1 = p384;
+	pMinus1.add(BigInteger<>("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"
+	                         "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"));
+	cout << "a^(p-1) mod P-384 is 1: " << prime.modexp(x, pMinus1).compare(BIG1) << endl;
+}
+
+/*
+ * Binary format in both byte orders and a view that reduces a value
+ * in place in a record buffer
+ */
+void testBytes()
+{
+	cout << endl << "Running testBytes()" << endl;
+	cout << endl;
+
+	BigInteger<192> v("0123456789ABCDEFFEDCBA98765432100F1E2D3C4B5A6978");
+	unsigned char buf[BigInteger<192>::BYTES];
+	cout << "big-endian bytes:    ";
+	v.toBytes(buf, BIG_INTEGER_BIG_ENDIAN);
+	for (int i=0; i<BigInteger<192>::BYTES; i++)
+		cout << (buf[i] >> 4) << (buf[i] & 0x0f);
+	BigInteger<192> w;
+	cout << endl << "round trip: " << w.fromBytes(buf, BIG_INTEGER_BIG_ENDIAN).compare(v);
+	cout << endl << "little-endian bytes: ";
+	v.toBytes(buf, BIG_INTEGER_LITTLE_ENDIAN);
+	for (int i=0; i<BigInteger<192>::BYTES; i++)
+		cout << (buf[i] >> 4) << (buf[i] & 0x0f);
+	cout << endl << "round trip: " << w.fromBytes(buf, BIG_INTEGER_LITTLE_ENDIAN).compare(v) << endl;
+
+	// two 384-bit records side by side, the second one is reduced in place
+	bigIntType records[2 * BigInteger<>::WORDS];
+	BigInteger<> x("FEDCBA98765432100123456789ABCDEF1122334455667788"
+	               "99AABBCCDDEEFF000F1E2D3C4B5A69788796A5B4C3D2E1F0");
+	x.toBytes((unsigned char *)&records[BigInteger<>::WORDS], BIG_INTEGER_LITTLE_ENDIAN);
+	BigIntegerView<> view(&records[BigInteger<>::WORDS]);
+	view.modp192();
+	cout << "record mod p192 = " << view.value() << ", equal to modp192: " << view.compare(x.modp192()) << endl;
+}
+
+/*
+ * Shifts in both directions, bitwise operations, bitLength() and
+ * testBit()
+ */
+void testShift()
+{
+	cout << endl << "Running testShift()" << endl;
+	cout << endl;
+
+	BigInteger<> x("0123456789ABCDEFFEDCBA98765432100F1E2D3C4B5A6978");
+	BigInteger<> mask("FFFF0000FFFF0000FFFF0000FFFF0000FFFF0000FFFF0000");
+	BigInteger<> y;
+	cout << "x << 100     = " << y.shiftLeft(x, 100) << endl;
+	cout << "x >> 100     = " << y.shiftRight(x, 100) << endl;
+	cout << "(x << 100) >> 100 == x: " << y.shiftLeft(x, 100).shiftRight(100).compare(x) << endl;
+	y = x;
+	cout << "x AND mask   = " << y.bitAnd(mask) << endl;
+	y = x;
+	cout << "x OR mask    = " << y.bitOr(mask) << endl;
+	y = x;
+	cout << "x XOR mask   = " << y.bitXor(mask) << endl;
+	cout << "bitLength(x) = " << std::dec << x.bitLength() << ", bit 0: " << x.testBit(0)
+	     << ", bit 3: " << x.testBit(3) << std::hex << endl;
+}
+
+/*
+ * Three-way comparison, sorting and deduplication with std::hash
+ */
+void testOrder()
+{
+	cout << endl << "Running testOrder()" << endl;
+	cout << endl;
+
+	std::vector<BigInteger<192> > values;
+	BigInteger<192> v("FEDCBA98765432100123456789ABCDEF1122334455667788");
+	BigInteger<192> step("0123456789ABCDEFFEDCBA98765432100F1E2D3C4B5A6978");
+	for (int i=0; i<8; i++) {
+		values.push_back(v);
+		values.push_back(v);						// every value twice
+		v.mulmod192(step);
+	}
+	std::sort(values.begin(), values.end());
+	bool sorted = true;
+	for (size_t i=1; i<values.size(); i++)
+		sorted = sorted && values[i-1].compareTo(values[i]) <= 0;
+	std::unordered_set<BigInteger<192> > unique(values.begin(), values.end());
+	cout << "smallest = " << values.front() << endl;
+	cout << "largest  = " << values.back() << endl;
+	cout << "sorted: " << sorted << ", " << std::dec << values.size() << " values, "
+	     << unique.size() << " distinct" << std::hex << endl;
+	cout << "compareTo: " << std::dec << values.front().compareTo(values.back()) << " "
+	     << values.back().compareTo(values.front()) << " " << values[0].compareTo(values[1]) << std::hex << endl;
+}
+
+//---------------------------------------------------------------
+/*
+ * Decimal strings in both directions: p192 and 2^2048 - 1, which is
+ * converted by divide-and-conquer
+ */
+void testDecimal()
+{
+	cout << endl << "Running testDecimal()" << endl;
+	cout << endl;
+
+	BigInteger<192> p("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFF");
+	char buf[BigInteger<2048>::DECIMAL_CHARS];
+	std::string decimal(buf, p.toDecimal(buf));
+	BigInteger<192> q;
+	cout << "p192 = " << decimal << endl;
+	cout << "expected value: " << (decimal == "6277101735386680763835789423207666416083908700390324961279")
+	     << ", round trip: " << q.fromDecimal(decimal).compare(p) << endl;
+
+	BigInteger<2048> x(std::string(BigInteger<2048>::HEX_CHARS, 'F').c_str()), y;
+	decimal.assign(buf, x.toDecimal(buf));
+	cout << "2^2048 - 1 = " << decimal.substr(0, 20) << "..." << decimal.substr(decimal.size() - 20)
+	     << std::dec << ", " << decimal.size() << " digits" << std::hex << endl;
+	cout << "round trip: " << y.fromDecimal(decimal).compare(x) << endl;
+}
+
+/*
+ * Variable-length values: inline up to 384 bits, arena blocks above,
+ * recycled across a loop of 2203-bit modular products
+ */
+void testVar()
+{
+	cout << endl << "Running testVar()" << endl;
+	cout << endl;
+
+	BigIntegerVar x(BigInteger<>("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"));
+	cout << "2^384 - 1 inline: " << x.isInline();
+	x.add(BigIntegerVar(1));
+	cout << ", + 1 = " << x << ", inline: " << x.isInline() << endl;
+
+	// (2^2048 + 1)^2 = 2^4096 + 2^2049 + 1
+	BigIntegerVar y(1), expected(1);
+	y.shiftLeft(2048).add(BigIntegerVar(1));
+	y.mul(y);
+	expected.shiftLeft(4096).add(BigIntegerVar(1).shiftLeft(2049)).add(BigIntegerVar(1));
+	cout << "(2^2048 + 1)^2: " << std::dec << y.bitLength() << " bits, " << y.words() << " words" << std::hex
+	     << ", correct: " << y.compare(expected) << endl;
+
+	BigIntegerVar q(y), r;
+	q.divmod(BigIntegerVar(1).shiftLeft(2048).add(BigIntegerVar(1)), r);
+	cout << "divided by 2^2048 + 1: remainder " << r << ", quotient 2^2048 + 1: "
+	     << q.compare(BigIntegerVar(1).shiftLeft(2048).add(BigIntegerVar(1))) << endl;
+
+	// the Mersenne prime m = 2^2203 - 1: 3^(m-1) = 1 by repeated modular products
+	BigIntegerVar m(1);
+	m.shiftLeft(2203).sub(BigIntegerVar(1));
+	BigIntegerVar a(3), power(1), e(m);
+	e.sub(BigIntegerVar(1));
+	size_t chunks = 0;
+	for (int i=e.bitLength()-1; i>=0; i--) {
+		power.mul(power).mod(m);
+		if (e.testBit(i))
+			power.mul(a).mod(m);
+		if (i == e.bitLength()-2)
+			chunks = BigIntegerArena::local().chunkCount();
+	}
+	cout << "3^(m-1) mod m = " << power << ", arena chunks after the first step: " << std::dec << chunks
+	     << ", at the end: " << BigIntegerArena::local().chunkCount() << std::hex << endl;
+
+	std::string decimal(m.decimalChars(), '\0');
+	decimal.resize(m.toDecimal(&decimal[0]) - &decimal[0]);
+	cout << "m = " << decimal.substr(0, 20) << "..." << decimal.substr(decimal.size() - 20) << endl;
+
+	// copies made by another thread, also the one inside sub(), take the blocks of its arena
+	bool ownArena = false, correct = false;
+	std::thread other([&]{
+		BigIntegerVar twice(m);
+		ownArena = BigIntegerArena::local().chunkCount() > 0;
+		BigIntegerVar difference(1);
+		twice.add(m);
+		difference.sub(m);
+		correct = difference.compare(e) && twice.compare(BigIntegerVar(m).shiftLeft(1));
+	});
+	other.join();
+	cout << "m copied on another thread: its own arena " << ownArena << ", correct " << correct << endl;
+}
+
+/*
+ * Expression templates: a fused (a + b + (c << 3)) % P192 against the
+ * same formula with in-place operations on 384-bit copies
+ */
+void testExpr()
+{
+	cout << endl << "Running testExpr()" << endl;
+	cout << endl;
+
+	BigInteger<192> a("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFE");	// p - 1
+	BigInteger<192> b("0123456789ABCDEFFEDCBA98765432100F1E2D3C4B5A6978");
+	BigInteger<192> c("F0E1D2C3B4A5968778695A4B3C2D1E0FFEDCBA9876543210");
+	BigInteger<192> r = (a + b + (c << 3)) % P192;
+
+	BigInteger<> x(a), y(b), z(c);
+	x.addc(y).addc(z.shiftLeft(3)).modp192();
+	cout << "(a + b + (c << 3)) % P192 = " << r << ", in place: " << BigInteger<192>(x)
+	     << ", equal: " << r.compare(BigInteger<192>(x)) << endl;
+
+	// without % P192 the sum wraps like addc() and shiftLeft()
+	BigInteger<192> wrapped = a + b + (c << 3);
+	BigInteger<192> u(a), v(c);
+	u.addc(b).addc(v.shiftLeft(3));
+	cout << "a + b + (c << 3) = " << wrapped << ", equal to addc: " << wrapped.compare(u) << endl;
+	cout << "((a + b) << 1) % P192 == (a + a + b + b) % P192: "
+	     << (((a + b) << 1) % P192).compare((a + a + b + b) % P192) << endl;
+
+	// large shifts against in-place shifts on 2048 bits, where nothing is cut off
+	bool exact = true;
+	const unsigned int shifts[] = {64, 128, 129, 191, 200, 1000, 1800};
+	for (unsigned int s : shifts) {
+		BigInteger<2048> x(c);
+		x.shiftLeft(s).modp192();
+		exact = exact && ((c << s) % P192).compare(BigInteger<192>(x));
+	}
+	BigInteger<2048> wb(b), wc(c), w(a);
+	w.addc(wb.shiftLeft(300)).addc(wc.shiftLeft(1000)).modp192();
+	BigInteger<192> mixed = (a + (b << 300) + (c << 1000)) % P192;
+	cout << "(c << s) % P192 for s = 64 ... 1800 exact: " << exact
+	     << ", (a + (b << 300) + (c << 1000)) % P192 = " << mixed << ", equal: " << mixed.compare(BigInteger<192>(w)) << endl;
+
+	constexpr BigInteger<> folded = (BIG1 + (BIG1 << 192)) % P192;
+	cout << "constexpr (1 + 2^192) % P192 = " << folded << endl;
+}
+
+/*
+ * Streaming reduction: a text of several blocks with comments, CRLF
+ * and a last line without newline, streamed by 3 workers and compared
+ * to the bulk reduction of the same text in memory
+ */
+void testStream()
+{
+	cout << endl << "Running testStream()" << endl;
+	cout << endl;
+
+	std::string text = "// comment\r\n\n";
+	BigInteger<384> x("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF0123456789ABCDEFFEDCBA9876543210F0E1D2C3B4A59687");
+	char buf[BigInteger<384>::HEX_CHARS + 1];
+	for (int i=0; i<40000; i++) {
+		*x.toHex(buf) = '\0';
+		text += buf;
+		text += (i % 3) ? "\n" : "\r\n";
+		x.shiftLeft(7).addc(BigInteger<384>(i));
+	}
+	text += "123456789abcdef";
+
+	FILE *in = tmpfile(), *out = tmpfile();
+	fwrite(text.data(), 1, text.size(), in);
+	fflush(in);
+	lseek(fileno(in), 0, SEEK_SET);
+	bigIntegerBulkStats stats;
+	bool ok = bigIntegerStreamReduce(fileno(in), fileno(out), 3, &stats);
+
+	std::string streamed(lseek(fileno(out), 0, SEEK_END), '\0');
+	lseek(fileno(out), 0, SEEK_SET);
+	ok = ok && read(fileno(out), &streamed[0], streamed.size()) == (ssize_t)streamed.size();
+	std::string expected;
+	bigIntegerBulkReduceLines(text.data(), text.data() + text.size(), expected);
+	fclose(in);
+	fclose(out);
+
+	cout << "streamed " << std::dec << stats.values << " values in " << stats.chunks << " blocks by "
+	     << stats.threads << " workers" << std::hex << ", ok: " << ok
+	     << ", equal to the bulk reduction: " << (streamed == expected) << endl;
+	cout << "last line: " << streamed.substr(streamed.size() - 49);
+
+	// a slow pipe: the first line has to come back while the input is still open
+	int request[2], reply[2];
+	ok = pipe(request) == 0 && pipe(reply) == 0;
+	std::thread streaming([&]{ bigIntegerStreamReduce(request[0], reply[1], 2); close(reply[1]); });
+	ok = ok && write(request[1], "12\n", 3) == 3;
+	struct pollfd ready = { reply[0], POLLIN, 0 };
+	const bool early = poll(&ready, 1, 10000) == 1;
+	ok = ok && write(request[1], "34\n", 3) == 3;
+	close(request[1]);
+	streaming.join();
+	std::string answer;
+	ssize_t got;
+	while ((got = read(reply[0], buf, sizeof(buf))) > 0)
+		answer.append(buf, got);
+	close(request[0]);
+	close(reply[0]);
+	cout << "slow pipe: first line answered before the input ended: " << early << ", ok: " << ok
+	     << ", reply: " << (answer == std::string(46, '0') + "12\n" + std::string(46, '0') + "34\n") << endl;
+
+	// an invalid line ends the stream, the values in front of it are written
+	const std::string bad = "12\n34\n0x56\n78\n";
+	in = tmpfile();
+	out = tmpfile();
+	fwrite(bad.data(), 1, bad.size(), in);
+	fflush(in);
+	lseek(fileno(in), 0, SEEK_SET);
+	errno = 0;
+	ok = bigIntegerStreamReduce(fileno(in), fileno(out), 2, &stats);
+	const bool invalid = errno == EINVAL;
+	cout << "invalid line: ok " << ok << ", EINVAL " << invalid << ", at byte " << std::dec << stats.invalidOffset
+	     << ", values written " << stats.values << ", output bytes " << lseek(fileno(out), 0, SEEK_END) << std::hex << endl;
+	fclose(in);
+	fclose(out);
+}
+
+/*
+ * Instrumentation: the counts of a known sequence of operations,
+ * only in a build with make STATS=1
+ */
+void testStats()
+{
+	cout << endl << "Running testStats()" << endl;
+	cout << endl;
+
+	if (!bigIntegerStatsEnabled()) {
+		bigIntegerStatsDump(cout);
+		return;
+	}
+	bigIntegerStatsReset();
+	BigInteger<> x("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF");
+	BigInteger<> p("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFF");
+	x.modp192();							// carries into the first fold
+	for (int i=0; i<10; i++)
+		x.mulmod192(x);
+	p.modp192();							// p itself: subtraction of p
+	BigInteger<> y("FFFFFFFFFFFFFFFF00000000000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF");
+	y.modp192();							// the first fold carries: second fold
+
+	bigIntegerOpStats ops[BIG_INTEGER_OP_COUNT];
+	uint64_t events[BIG_INTEGER_EVENT_COUNT];
+	bigIntegerStatsSnapshot(ops, events);
+	cout << "2^384 - 2^320 + 2^192 - 1 mod p192 = " << y << endl;
+	cout << std::dec << "calls: fromHex " << ops[BIG_INTEGER_OP_FROM_HEX].calls
+	     << ", modp192 " << ops[BIG_INTEGER_OP_MODP192].calls
+	     << ", mulmod192 " << ops[BIG_INTEGER_OP_MULMOD192].calls
+	     << ", reduce192 kernel " << events[BIG_INTEGER_EVENT_REDUCE]
+	     << ", second folds " << events[BIG_INTEGER_EVENT_SECOND_FOLD]
+	     << ", subtractions of p " << events[BIG_INTEGER_EVENT_SUBTRACT_P] << std::hex << endl;
+	bigIntegerStatsDump(cout);
+}
+
+/*
+ * Square roots mod p192 and compressed points: 25 bytes instead of
+ * the 49 of the uncompressed encoding
+ */
+void testSqrt()
+{
+	cout << endl << "Running testSqrt()" << endl;
+	cout << endl;
+
+	BigInteger<192> d("0123456789ABCDEFFEDCBA98765432100F1E2D3C4B5A6978");
+	BigInteger<192> square = d, root;
+	square.sqrmod192();
+	root = square;
+	root.sqrtmod192();
+	BigInteger<192> minusD = BigInteger<192>().submod192(d);
+	cout << "sqrt(d^2) mod p = " << root << ", +-d: " << (root.compare(d) || root.compare(minusD)) << endl;
+	cout << "legendre: d^2 " << std::dec << square.legendre192()
+	     << ", p - 1 " << BigInteger<192>("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFE").legendre192()
+	     << ", 0 " << BigInteger<192>().legendre192() << std::hex << endl;
+
+	unsigned char buf[P192_COMPRESSED_BYTES];
+	P192Point q = P192Point::mulBase(d), decoded;
+	size_t size = q.toCompressed(buf) - buf;
+	cout << "compressed k * G: " << std::dec << size << " bytes, prefix " << (int)buf[0] << std::hex
+	     << ", decoded: " << decoded.fromCompressed(buf, size) << ", equal: " << decoded.equals(q) << endl;
+
+	// x = 1: 1 - 3 + b is not a square, no point has x = 1
+	unsigned char one[P192_COMPRESSED_BYTES] = {0x02};
+	one[P192_COMPRESSED_BYTES - 1] = 1;
+	cout << "x = 1 rejected: " << !decoded.fromCompressed(one, sizeof(one))
+	     << ", point kept: " << decoded.equals(q) << endl;
+}
+
 //---------------------------------------------------------------
 /*
  * Main function to start the application
+ * Without arguments the tests are run. "--stream [threads]" reduces
+ * the hex values on stdin mod p192 and writes them to stdout while
+ * they are read, for use in a pipeline, see BigIntegerStream.h
  */
 int main(int argc, char* argv[])
 {
+	if (argc > 1 && strcmp(argv[1], "--stream") == 0) {
+		unsigned int threads = (argc > 2) ? atoi(argv[2]) : 0;
+		bigIntegerBulkStats stats;
+		if (!bigIntegerStreamReduce(STDIN_FILENO, STDOUT_FILENO, threads, &stats)) {
+			if (errno == EINVAL)
+				std::cerr << "Assignment_A1: invalid value in the line at byte " << stats.invalidOffset << endl;
+			else
+				std::cerr << "Assignment_A1: " << strerror(errno) << endl;
+			return 1;
+		}
+		return 0;
+	}
+
 	cout << std::hex;
 	cout << "Rechnernetze und Organisation - Assignment A1" << endl;
+	cout << "Kernel variant: " << bigIntegerIsaName(bigIntegerSelectedIsa())
+	     << ", MULX/ADX multiplication: " << bigIntegerSelectedMulx() << endl;
 
 	// Running some "built in" tests
 	printConstants();
@@ -89,6 +763,24 @@ int main(int argc, char* argv[])
 
 	// Running your own test cases
 	testModp192();
+	testMulmod192();
+	testInvmod192();
+	testBatch();
+	testAccumulator();
+	testBulk();
+	testP192Point();
+	testMsm();
+	testReducer();
+	testMontgomery();
+	testBytes();
+	testShift();
+	testOrder();
+	testDecimal();
+	testVar();
+	testExpr();
+	testStream();
+	testStats();
+	testSqrt();
     getchar();
 	return 0;
 }
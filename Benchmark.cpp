@@ -0,0 +1,379 @@
+#include <iostream>
+	using std::cout;
+	using std::cerr;
+	using std::endl;
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdlib.h>
+#include <string.h>
+#include "BigInteger.h"
+#include "BigIntegerBatch.h"
+#include "BigIntegerAccumulator.h"
+#include "P192Point.h"
+#include "BigIntegerReducer.h"
+#include "BigIntegerMontgomery.h"
+#include "BigIntegerView.h"
+#include "BigIntegerVar.h"
+#include "BigIntegerExpr.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+ * Benchmark driver for the BigInteger operations
+ * Every operation is run on a set of inputs: the vectors of
+ * testcases.txt followed by random values. One sample times the
+ * operation on all inputs once and is divided by the input count.
+ * After the warmup samples the cycles/op (time-stamp counter) and
+ * ns/op of every sample are collected and reported as minimum,
+ * percentiles and mean.
+ *
+ * usage: Benchmark [testcases.txt] [--format=text|csv|json]
+ *                  [--samples=N] [--warmup=N] [--random=N]
+ */
+
+// Number of samples to take and to discard, random inputs to add
+static int samples = 200;
+static int warmup = 20;
+static int randomInputs = 1024;
+
+//---------------------------------------------------------------
+/*
+ * Reads the time-stamp counter. It counts at a constant reference
+ * rate, which equals the core clock only without frequency scaling.
+ */
+static inline unsigned long long cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/*
+ * Keeps the compiler from optimizing away the benchmarked results
+ */
+template <typename T>
+static inline void keep(T &value)
+{
+	__asm__ __volatile__("" : : "r"(&value) : "memory");
+}
+
+//---------------------------------------------------------------
+/*
+ * Result of one benchmarked operation
+ */
+struct benchResult {
+	std::string name;
+	double cyclesMin, cyclesP50, cyclesP90, cyclesP99, cyclesMean;
+	double nsMin, nsP50, nsP90, nsP99, nsMean;
+};
+
+static double percentile(const std::vector<double> &sorted, double p)
+{
+	size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+	return sorted[i];
+}
+
+/*
+ * Runs op() samples + warmup times. reset() restores the inputs
+ * before every sample and is not timed. op() processes all n inputs.
+ */
+template <typename Reset, typename Op>
+static benchResult measure(const char *name, size_t n, Reset reset, Op op)
+{
+	std::vector<double> c, ns;
+	for (int s=0; s<warmup+samples; s++) {
+		reset();
+		std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		unsigned long long c0 = cycles();
+		op();
+		unsigned long long c1 = cycles();
+		std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+		if (s < warmup)
+			continue;
+		c.push_back((double)(c1 - c0) / n);
+		ns.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / n);
+	}
+	std::sort(c.begin(), c.end());
+	std::sort(ns.begin(), ns.end());
+
+	benchResult r;
+	r.name = name;
+	r.cyclesMin = c.front();
+	r.cyclesP50 = percentile(c, 0.50);
+	r.cyclesP90 = percentile(c, 0.90);
+	r.cyclesP99 = percentile(c, 0.99);
+	r.nsMin = ns.front();
+	r.nsP50 = percentile(ns, 0.50);
+	r.nsP90 = percentile(ns, 0.90);
+	r.nsP99 = percentile(ns, 0.99);
+	r.cyclesMean = r.nsMean = 0;
+	for (size_t i=0; i<c.size(); i++) {
+		r.cyclesMean += c[i] / c.size();
+		r.nsMean += ns[i] / ns.size();
+	}
+	return r;
+}
+
+//---------------------------------------------------------------
+/*
+ * Reads the 384-bit hex vectors from a file in the testcases.txt
+ * format, comment and empty lines are skipped
+ */
+static void readVectors(const char *filename, std::vector<std::string> &vectors)
+{
+	std::ifstream in(filename);
+	if (!in) {
+		cerr << "Benchmark: cannot open " << filename << ", using random inputs only" << endl;
+		return;
+	}
+	std::string line;
+	while (std::getline(in, line)) {
+		line.erase(line.find_last_not_of(" \t\r") + 1);
+		if (line.empty() || line.compare(0, 2, "//") == 0)
+			continue;
+		vectors.push_back(line);
+	}
+}
+
+static void randomVectors(int n, std::vector<std::string> &vectors)
+{
+	std::mt19937_64 rng(0x5eed);
+	for (int i=0; i<n; i++) {
+		std::string s;
+		for (int j=0; j<BigInteger<>::WORDS * BIG_INTEGER_NUM_NIBBLES; j++)
+			s += "0123456789abcdef"[rng() & 0x0f];
+		vectors.push_back(s);
+	}
+}
+
+//---------------------------------------------------------------
+/*
+ * Benchmarks every operation on the given inputs
+ */
+static void runAll(const std::vector<std::string> &vectors, std::vector<benchResult> &results)
+{
+	const size_t n = vectors.size();
+	std::vector<BigInteger<> > input, work(n);
+	std::vector<BigInteger<192> > input192, work192(n);
+	for (size_t i=0; i<n; i++) {
+		input.push_back(BigInteger<>(vectors[i].c_str()));
+		input192.push_back(BigInteger<192>(input[i]));
+	}
+	std::ostringstream out;
+	BigIntegerBatch<> batch(n);
+	BigIntegerAccumulator acc;
+	BigInteger<> sum;
+	const BigIntegerReducer reducerP192(BigInteger<192>("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFF"));
+	const BigIntegerReducer reducerBarrett(BigInteger<192>("C0FFEE0123456789ABCDEF0123456789ABCDEF0123456789"));
+	BigInteger<> odd("C0FFEE0123456789ABCDEF0123456789ABCDEF0123456789"
+	                 "FEDCBA98765432100123456789ABCDEF1122334455667789");
+	const BigIntegerMontgomery<> montgomery(odd);
+	const size_t bytes = BigInteger<>::BYTES;
+	std::vector<unsigned char> wire(n * bytes);
+	std::vector<bigIntType> records(n * BigInteger<>::WORDS);	// little-endian records, 8-byte aligned
+	std::vector<char> text(n * BigInteger<>::DECIMAL_CHARS);
+	std::vector<std::string> decimals(n);
+	for (size_t i=0; i<n; i++)
+		decimals[i].assign(&text[0], input[i].toDecimal(&text[0]));
+
+	#define BENCH(name, body) \
+		results.push_back(measure(name, n, [&]{ work = input; work192 = input192; }, [&]{ \
+			for (size_t i=0; i<n; i++) { body; } keep(work); keep(work192); }))
+
+	BENCH("addc",      work[i].addc(input[(i+1) % n]));
+	BENCH("adda",      work[i].adda(input[(i+1) % n]));
+	BENCH("add",       work[i].add(input[(i+1) % n]));
+	BENCH("shiftLeft", work[i].shiftLeft(i % 384));
+	BENCH("shiftRight", work[i].shiftRight(i % 384));
+	BENCH("bitXor",    work[i].bitXor(input[(i+1) % n]));
+	BENCH("bitLength", int length = work[i].bitLength(); keep(length));
+	BENCH("compare",   bool equal = work[i].compare(input[(i+1) % n]); keep(equal));
+	BENCH("compare equal", bool equal = work[i].compare(input[i]); keep(equal));
+	BENCH("compareTo", int order = work[i].compareTo(input[(i+1) % n]); keep(order));
+	BENCH("hash",      size_t h = input[i].hash(); keep(h));
+	BENCH("modp192c",  work[i].modp192c());
+	BENCH("modp192a",  work[i].modp192a());
+	BENCH("modp192",   work[i].modp192());
+	BENCH("reduce p192",  reducerP192.reduce(work[i]));
+	BENCH("reduce p256",  BigIntegerReducer::p256().reduce(work[i]));
+	BENCH("reduce p384",  BigIntegerReducer::p384().reduce(work[i]));
+	BENCH("reduce barrett", reducerBarrett.reduce(work[i]));
+	BENCH("montmul cios", montgomery.mulCios(work[i], input[(i+1) % n]));
+	BENCH("montmul fios", montgomery.mulFios(work[i], input[(i+1) % n]));
+	BENCH("mul192",    work[i].mul192(input[(i+1) % n]));
+	BENCH("sqr192",    work[i].sqr192());
+	BENCH("mulmod192", work192[i].mulmod192(input192[(i+1) % n]));
+	BENCH("sqrmod192", work192[i].sqrmod192());
+	BENCH("invmod192", work192[i].invmod192());
+	BENCH("invmod192gcd", work192[i].invmod192gcd());
+	BENCH("sqrtmod192", work192[i].sqrtmod192());
+	BENCH("legendre192", int symbol = input192[i].legendre192(); keep(symbol));
+	BENCH("add+modp192", sum.add(input[i]).modp192(); keep(sum));
+	BENCH("expr in place", work[i].addc(input[(i+1) % n]).addc(sum.shiftLeft(input[(i+2) % n], 3)).modp192());
+	BENCH("expr fused", work[i] = (input[i] + input[(i+1) % n] + (input[(i+2) % n] << 3)) % P192);
+	BENCH("expr fused 192", work192[i] = (input192[i] + input192[(i+1) % n] + (input192[(i+2) % n] << 3)) % P192);
+	BENCH("accumulate", acc.add(input192[i]); keep(acc));
+	BENCH("parse",     work[i] = BigInteger<>(vectors[i].c_str()));
+	BENCH("format",    out.str(std::string()); out << input[i]; keep(out));
+	BENCH("toBytes",   input[i].toBytes(&wire[i * bytes], BIG_INTEGER_BIG_ENDIAN); keep(wire));
+	BENCH("fromBytes", work[i].fromBytes(&wire[i * bytes], BIG_INTEGER_BIG_ENDIAN));
+	BENCH("toDecimal", input[i].toDecimal(&text[i * BigInteger<>::DECIMAL_CHARS]); keep(text));
+	BENCH("fromDecimal", work[i].fromDecimal(decimals[i]));
+	#undef BENCH
+
+	results.push_back(measure("view modp192", n,
+		[&]{ for (size_t i=0; i<n; i++) input[i].toBytes((unsigned char *)&records[i * BigInteger<>::WORDS], BIG_INTEGER_LITTLE_ENDIAN); },
+		[&]{ for (size_t i=0; i<n; i++) BigIntegerView<>(&records[i * BigInteger<>::WORDS]).modp192(); keep(records); }));
+	results.push_back(measure("invmod192Batch", n, [&]{ work192 = input192; },
+		[&]{ BigInteger<192>::invmod192Batch(&work192[0], n); keep(work192); }));
+	std::vector<P192Point> points(n);
+	const size_t pointInputs = (n < 64) ? n : 64;			// scalar multiplications are slow
+	results.push_back(measure("P192 mulBase", pointInputs, []{},
+		[&]{ for (size_t i=0; i<pointInputs; i++) points[i] = P192Point::mulBase(input192[i]); keep(points); }));
+	results.push_back(measure("P192 mul", pointInputs, [&]{ for (size_t i=0; i<pointInputs; i++) points[i] = P192Point::generator(); },
+		[&]{ for (size_t i=0; i<pointInputs; i++) points[i].mul(input192[i]); keep(points); }));
+	for (size_t i=0; i<n; i++)
+		points[i] = P192Point::mulBase(input192[(i+1) % n]);
+	results.push_back(measure("P192 msm", n, []{},
+		[&]{ P192Point r = P192Point::msm(&points[0], &input192[0], n); keep(r); }));
+	std::vector<unsigned char> compressed(n * P192_COMPRESSED_BYTES);
+	for (size_t i=0; i<n; i++)
+		points[i].toCompressed(&compressed[i * P192_COMPRESSED_BYTES]);
+	results.push_back(measure("P192 decompress", n, []{},
+		[&]{ for (size_t i=0; i<n; i++) points[i].fromCompressed(&compressed[i * P192_COMPRESSED_BYTES], P192_COMPRESSED_BYTES); keep(points); }));
+	std::string hex2048;
+	for (size_t i=0; hex2048.size() < 2 * BigInteger<2048>::HEX_CHARS; i++)
+		hex2048 += vectors[i % n];
+	std::string modulusHex = hex2048.substr(0, BigInteger<2048>::HEX_CHARS);
+	modulusHex[0] = 'F';
+	modulusHex[BigInteger<2048>::HEX_CHARS - 1] = 'F';				// odd, full width
+	const BigIntegerMontgomery<2048> montgomery2048(BigInteger<2048>(modulusHex.c_str()));
+	const BigInteger<2048> exponent2048(hex2048.substr(BigInteger<2048>::HEX_CHARS).c_str());
+	const size_t expInputs = (n < 4) ? n : 4;
+	std::vector<BigInteger<2048> > work2048(expInputs);
+	results.push_back(measure("modexp 384", pointInputs, [&]{ work = input; },
+		[&]{ for (size_t i=0; i<pointInputs; i++) montgomery.modexp(work[i], input[(i+1) % n]); keep(work); }));
+	results.push_back(measure("modexp 2048", expInputs,
+		[&]{ for (size_t i=0; i<expInputs; i++) work2048[i] = BigInteger<2048>(input[i]); },
+		[&]{ for (size_t i=0; i<expInputs; i++) montgomery2048.modexp(work2048[i], exponent2048); keep(work2048); }));
+	// full-width 2048-bit values: divide-and-conquer decimal conversion
+	std::vector<BigInteger<2048> > input2048(pointInputs), parsed2048(pointInputs);
+	std::vector<std::string> decimals2048(pointInputs);
+	std::vector<char> text2048(BigInteger<2048>::DECIMAL_CHARS);
+	for (size_t i=0; i<pointInputs; i++) {
+		input2048[i] = BigInteger<2048>(hex2048.substr(i % BigInteger<2048>::HEX_CHARS, BigInteger<2048>::HEX_CHARS).c_str());
+		decimals2048[i].assign(&text2048[0], input2048[i].toDecimal(&text2048[0]));
+	}
+	results.push_back(measure("toDecimal 2048", pointInputs, []{},
+		[&]{ for (size_t i=0; i<pointInputs; i++) input2048[i].toDecimal(&text2048[0]); keep(text2048); }));
+	results.push_back(measure("fromDecimal 2048", pointInputs, []{},
+		[&]{ for (size_t i=0; i<pointInputs; i++) parsed2048[i].fromDecimal(decimals2048[i]); keep(parsed2048); }));
+	// variable length: inline at 384 bits, arena blocks at 2048 bits
+	std::vector<BigIntegerVar> var384, var2048, work2048var;
+	for (size_t i=0; i<pointInputs; i++) {
+		var384.push_back(BigIntegerVar(input[i]));
+		var2048.push_back(BigIntegerVar(input2048[i]));
+	}
+	const BigIntegerVar modulusVar(BigInteger<2048>(modulusHex.c_str()));
+	results.push_back(measure("var add 384", pointInputs, [&]{ work2048var = var384; },
+		[&]{ for (size_t i=0; i<pointInputs; i++) work2048var[i].add(var384[(i+1) % pointInputs]); keep(work2048var); }));
+	results.push_back(measure("var mulmod 2048", pointInputs, [&]{ work2048var = var2048; },
+		[&]{ for (size_t i=0; i<pointInputs; i++) work2048var[i].mul(var2048[(i+1) % pointInputs]).mod(modulusVar); keep(work2048var); }));
+	results.push_back(measure("batch modp192c", n,
+		[&]{ for (size_t i=0; i<n; i++) batch.set(i, input[i]); },
+		[&]{ batch.modp192c(); keep(batch); }));
+}
+
+//---------------------------------------------------------------
+/*
+ * Output of the results as text table, CSV or JSON
+ */
+static void printResults(const std::vector<benchResult> &results, const std::string &format, size_t inputs)
+{
+	const char *isa = bigIntegerIsaName(bigIntegerSelectedIsa());
+	if (format == "csv") {
+		cout << "operation,isa,inputs,cycles_min,cycles_p50,cycles_p90,cycles_p99,cycles_mean,"
+		        "ns_min,ns_p50,ns_p90,ns_p99,ns_mean" << endl;
+		for (size_t i=0; i<results.size(); i++) {
+			const benchResult &r = results[i];
+			cout << r.name << "," << isa << "," << inputs << ","
+			     << r.cyclesMin << "," << r.cyclesP50 << "," << r.cyclesP90 << "," << r.cyclesP99 << "," << r.cyclesMean << ","
+			     << r.nsMin << "," << r.nsP50 << "," << r.nsP90 << "," << r.nsP99 << "," << r.nsMean << endl;
+		}
+	} else if (format == "json") {
+		cout << "{\"isa\": \"" << isa << "\", \"inputs\": " << inputs << ", \"samples\": " << samples
+		     << ", \"results\": [" << endl;
+		for (size_t i=0; i<results.size(); i++) {
+			const benchResult &r = results[i];
+			cout << "  {\"operation\": \"" << r.name << "\""
+			     << ", \"cycles\": {\"min\": " << r.cyclesMin << ", \"p50\": " << r.cyclesP50 << ", \"p90\": " << r.cyclesP90
+			     << ", \"p99\": " << r.cyclesP99 << ", \"mean\": " << r.cyclesMean << "}"
+			     << ", \"ns\": {\"min\": " << r.nsMin << ", \"p50\": " << r.nsP50 << ", \"p90\": " << r.nsP90
+			     << ", \"p99\": " << r.nsP99 << ", \"mean\": " << r.nsMean << "}}"
+			     << (i+1 < results.size() ? "," : "") << endl;
+		}
+		cout << "]}" << endl;
+	} else {
+		cout << "BigInteger benchmark, kernel variant " << isa << ", " << inputs << " inputs, "
+		     << samples << " samples" << endl << endl;
+		cout.setf(std::ios::fixed);
+		cout.precision(1);
+		cout << "operation         cycles/op:    min        p50        p90        p99  |  ns/op:     min        p50        p99" << endl;
+		for (size_t i=0; i<results.size(); i++) {
+			const benchResult &r = results[i];
+			cout.width(16); cout << std::left << r.name << std::right;
+			cout.width(19); cout << r.cyclesMin;
+			cout.width(11); cout << r.cyclesP50;
+			cout.width(11); cout << r.cyclesP90;
+			cout.width(11); cout << r.cyclesP99 << "  |";
+			cout.width(15); cout << r.nsMin;
+			cout.width(11); cout << r.nsP50;
+			cout.width(11); cout << r.nsP99 << endl;
+		}
+	}
+}
+
+//---------------------------------------------------------------
+/*
+ * Main function of the benchmark
+ */
+int main(int argc, char* argv[])
+{
+	const char *filename = "testcases.txt";
+	std::string format = "text";
+	for (int i=1; i<argc; i++) {
+		if (strncmp(argv[i], "--format=", 9) == 0)
+			format = argv[i] + 9;
+		else if (strncmp(argv[i], "--samples=", 10) == 0)
+			samples = atoi(argv[i] + 10);
+		else if (strncmp(argv[i], "--warmup=", 9) == 0)
+			warmup = atoi(argv[i] + 9);
+		else if (strncmp(argv[i], "--random=", 9) == 0)
+			randomInputs = atoi(argv[i] + 9);
+		else
+			filename = argv[i];
+	}
+	if (samples < 1)
+		samples = 1;
+
+	std::vector<std::string> vectors;
+	readVectors(filename, vectors);
+	randomVectors(randomInputs, vectors);
+	if (vectors.empty()) {
+		cerr << "Benchmark: no inputs" << endl;
+		return 1;
+	}
+
+	std::vector<benchResult> results;
+	runAll(vectors, results);
+	printResults(results, format, vectors.size());
+	return 0;
+}
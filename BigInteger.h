@@ -3,43 +3,718 @@
 
 #include <iostream>
 	using std::ostream;
+#include <stdint.h>
+#include <stddef.h>
+#include <string_view>
+#include <functional>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 // type definition of word-level datatype
-typedef unsigned long bigIntType;
+typedef uint64_t bigIntType;
 
-// Number of 32-bit words concatenated to BigInteger
-#define BIG_INTEGER_MAX_WORDS 12
+// Number of bits per word
+#define BIG_INTEGER_WORD_BITS 64
+
+// Number of hexadecimal characters (nibbles) per word
+#define BIG_INTEGER_NUM_NIBBLES (BIG_INTEGER_WORD_BITS / 4)
+
+// Width in bits of a BigInteger<> without explicit width
+#define BIG_INTEGER_DEFAULT_BITS 384
+
+// The word count of every BigInteger<Bits> is a compile-time constant,
+// so the word loops are unrolled completely
+#if defined(__clang__)
+#define BIG_INTEGER_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+#define BIG_INTEGER_UNROLL _Pragma("GCC unroll 16")
+#else
+#define BIG_INTEGER_UNROLL
+#endif
+
+// True while a constant expression is evaluated: the constexpr members
+// take their portable path then and the runtime kernels otherwise
+#if defined(__GNUC__)
+#define BIG_INTEGER_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define BIG_INTEGER_CONSTANT_EVALUATED() true
+#endif
+
+// Kernel variants selected at runtime, each level includes the ones below
+enum bigIntegerIsa {
+	BIG_INTEGER_ISA_PORTABLE,		// portable C++
+	BIG_INTEGER_ISA_X86_64,			// x86-64 ADD/ADC chains
+	BIG_INTEGER_ISA_AVX2,			// AVX2 batch kernels
+	BIG_INTEGER_ISA_BMI2_ADX,		// MULX/ADCX/ADOX multiplication
+	BIG_INTEGER_ISA_AVX512			// AVX-512 batch kernels
+};
+bigIntegerIsa bigIntegerSelectedIsa();				// variant in use, see BigInteger.cpp
+bool bigIntegerSelectedMulx();						// MULX/ADX multiplication in use, also below bmi2-adx
+const char *bigIntegerIsaName(bigIntegerIsa isa);	// name as used by BIG_INTEGER_ISA
+
+// Byte order of the binary format, see toBytes()
+enum bigIntegerByteOrder {
+	BIG_INTEGER_LITTLE_ENDIAN,		// least significant byte first
+	BIG_INTEGER_BIG_ENDIAN			// most significant byte first
+};
+
+// Word-array kernels of any length in BigInteger.cpp, the fixed-width
+// members and BigIntegerVar share them. Word 0 is least significant.
+bigIntType bigIntegerAddWords(bigIntType r[], const bigIntType a[], int n);	// r += a, returns the carry
+bigIntType bigIntegerSubWords(bigIntType r[], const bigIntType a[], int n);	// r -= a, returns the borrow
+bigIntType bigIntegerMulWordAdd(bigIntType x[], int n, bigIntType m, bigIntType a);	// x = x * m + a, returns the carry
+bigIntType bigIntegerDivWord(bigIntType x[], int n, bigIntType d);	// x /= d, returns the remainder
+void bigIntegerMulWords(bigIntType r[], const bigIntType a[], int na, const bigIntType b[], int nb);	// r = a * b
+void bigIntegerDivWords(bigIntType q[], bigIntType r[], const bigIntType u[], int m,
+                        const bigIntType v[], int n, bigIntType scratch[]);	// u = q * v + r
+void bigIntegerParseHex(bigIntType x[], int n, std::string_view str);	// x = hexadecimal string
+char *bigIntegerFormatHex(char *buf, const bigIntType x[], int n, bool leadingZeros);	// write hexadecimal
+void bigIntegerParseDecimal(bigIntType x[], int n, std::string_view str);	// x = decimal string
+char *bigIntegerFormatDecimal(char *buf, bigIntType x[], int n);	// write decimal, x is destroyed
+
+template <unsigned int Bits = BIG_INTEGER_DEFAULT_BITS> class BigInteger;
+template <unsigned int Bits = BIG_INTEGER_DEFAULT_BITS> class BigIntegerBatch;
+class BigIntegerAccumulator;
+class BigIntegerReducer;
+class BigIntegerVar;
+template <unsigned int Bits, int Terms> class BigIntegerSum;
+template <unsigned int Bits> class BigIntegerMontgomery;
+class P192Point;
+template <unsigned int Bits> ostream& operator << (ostream&, const BigInteger<Bits> &);
 
 //---------------------------------------------------------------
 /*
  * Datatype to handle big numbers
- * Information is handled in value[], an unsigned long array of the size BigInteger_MAX_WORDS
+ * Information is handled in value[], a 64-bit word array. The number
+ * of words is derived from the template parameter Bits at compile
+ * time (rounded up to whole words), so a 192-bit field element uses
+ * three words while the 384-bit product of two of them uses six.
+ * The widths 192, 256, 384, 521, 1024 and 2048 are instantiated in
+ * BigInteger.cpp.
+ * The constructors, addc(), the shift and bitwise operations, the
+ * comparisons and modp192c() are constexpr and defined in this
+ * header, so constants can be built at compile time, e.g. with the
+ * literal 0x..._big. The comparison operators and std::hash make
+ * BigInteger usable as key of ordered and unordered containers.
  */
+template <unsigned int Bits>
 class BigInteger
 {
-	friend ostream& operator << (ostream&, const BigInteger &);
+	friend ostream& operator << <Bits>(ostream&, const BigInteger<Bits> &);
+	template <unsigned int> friend class BigInteger;
+	friend class BigIntegerBatch<Bits>;
+	friend class BigIntegerAccumulator;
+	friend class BigIntegerReducer;
+	friend class BigIntegerVar;
+	template <unsigned int, int> friend class BigIntegerSum;
+	template <unsigned int> friend class BigIntegerMontgomery;
+	friend class P192Point;
+public:
+	// Number of 64-bit words concatenated to BigInteger
+	static const int WORDS = (Bits + BIG_INTEGER_WORD_BITS - 1) / BIG_INTEGER_WORD_BITS;
+	// Number of hexadecimal characters of the full value, see toHex()
+	static const int HEX_CHARS = WORDS * BIG_INTEGER_NUM_NIBBLES;
+	// Number of bytes of the binary format, see toBytes()
+	static const int BYTES = WORDS * (BIG_INTEGER_WORD_BITS / 8);
+	// Room toDecimal() needs: the digits of the full value (log10(2) =
+	// 0.30103) and 18 more, the last chunk of 19 digits is written whole
+	static const int DECIMAL_CHARS = (WORDS * BIG_INTEGER_WORD_BITS * 30103) / 100000 + 1 + 18;
 private:
 	// The value of the BigInteger
 	//	value[0] is the least-significant word
-	//	value[max_32bitwords-1] is the most-significant word
-	bigIntType value[BIG_INTEGER_MAX_WORDS];
+	//	value[WORDS-1] is the most-significant word
+	bigIntType value[WORDS];
 public:
-	BigInteger(void);							// default constructor
-	BigInteger(bigIntType val);					// constructor to initialize instance with long
-	BigInteger(const char str[]);				// constructor to initialize instance with string
-	~BigInteger(void);							// destructor
-	BigInteger& addc(const BigInteger &addend);	// multi-precision addition
+	constexpr BigInteger(void);					// default constructor
+	constexpr BigInteger(bigIntType val);		// constructor to initialize instance with long
+	constexpr BigInteger(const char str[]);		// constructor to initialize instance with string
+	template <unsigned int OtherBits>
+	constexpr explicit BigInteger(const BigInteger<OtherBits> &other);	// constructor to convert between widths
+	BigInteger& fromHex(std::string_view str);	// set from hexadecimal string
+	char *toHex(char *buf, bool leadingZeros = true) const;	// write hexadecimal string
+	BigInteger& fromDecimal(std::string_view str);	// set from decimal string
+	char *toDecimal(char *buf) const;			// write decimal string
+	BigInteger& fromBytes(const unsigned char buf[], bigIntegerByteOrder order);	// set from binary format
+	unsigned char *toBytes(unsigned char buf[], bigIntegerByteOrder order) const;	// write binary format
+	BigInteger& add(const BigInteger &addend);	// multi-precision addition, fastest variant
+	constexpr BigInteger& addc(const BigInteger &addend);	// multi-precision addition
 	BigInteger& adda(const BigInteger &addend);	// multi-precision addition
-	BigInteger& shiftLeft(unsigned int val);	// multi-precision shift-left
-	BigInteger& modp192c();						// modular reduction
+	constexpr BigInteger& shiftLeft(unsigned int val);	// multi-precision shift-left
+	constexpr BigInteger& shiftLeft(const BigInteger &src, unsigned int val);	// *this = src << val
+	constexpr BigInteger& shiftRight(unsigned int val);	// multi-precision shift-right
+	constexpr BigInteger& shiftRight(const BigInteger &src, unsigned int val);	// *this = src >> val
+	constexpr BigInteger& bitAnd(const BigInteger &mask);	// bitwise AND
+	constexpr BigInteger& bitOr(const BigInteger &mask);	// bitwise OR
+	constexpr BigInteger& bitXor(const BigInteger &mask);	// bitwise XOR
+	constexpr int bitLength() const;			// position of the highest set bit + 1, 0 for 0
+	constexpr bool testBit(unsigned int n) const;	// bit n set?
+	BigInteger& modp192();						// modular reduction, fastest variant
+	constexpr BigInteger& modp192c();			// modular reduction
 	BigInteger& modp192a();						// modular reduction
-	bool compare(const BigInteger &testme);		// multi-precision comparison
+	BigInteger& mul192(const BigInteger &factor);	// 192x192 -> 384-bit multiplication
+	BigInteger& sqr192();						// 192 -> 384-bit squaring
+	BigInteger& addmod192(const BigInteger &addend);	// modular addition mod p192
+	BigInteger& submod192(const BigInteger &subtrahend);	// modular subtraction mod p192
+	BigInteger& mulmod192(const BigInteger &factor);	// modular multiplication mod p192
+	BigInteger& sqrmod192();					// modular squaring mod p192
+	BigInteger& invmod192();					// modular inversion mod p192, Fermat
+	BigInteger& invmod192gcd();					// modular inversion mod p192, binary GCD
+	static void invmod192Batch(BigInteger values[], size_t n);	// inverts n values at once
+	BigInteger& sqrtmod192();					// modular square root mod p192
+	int legendre192() const;					// quadratic character mod p192: 1, -1 or 0
+	constexpr bool compare(const BigInteger &testme) const;	// multi-precision comparison
+	constexpr int compareTo(const BigInteger &other) const;	// three-way comparison: -1, 0, 1
+	constexpr size_t hash() const;				// hash value of all words
 };
 
+//---------------------------------------------------------------
+/*
+ * Constructor
+ * Default constructor zeroes out the value array
+ */
+template <unsigned int Bits>
+constexpr BigInteger<Bits>::BigInteger(void) : value{}
+{
+}
+
+/*
+ * Constructor: from (long) Integer
+ * zeroes out the value array
+ * @param val is set to the first position in the value array
+ */
+template <unsigned int Bits>
+constexpr BigInteger<Bits>::BigInteger(bigIntType val) : value{val}
+{
+}
+
+/*
+ * Constructor
+ * A string is taken to initialize the instance, see fromHex().
+ * The string ends at the terminating zero. In a constant expression
+ * the digits are decoded one by one, at runtime by fromHex().
+ * @param str the string to initialize the BigInteger instance
+ */
+template <unsigned int Bits>
+constexpr BigInteger<Bits>::BigInteger(const char str[]) : value{}
+{
+	size_t length = 0;
+	while (str[length] > 0)
+		length++;
+	if (BIG_INTEGER_CONSTANT_EVALUATED()) {
+		for (size_t i=0; i<length && i<(size_t)HEX_CHARS; i++) {
+			char c = str[length-1-i];
+			bigIntType nibble = (c & 0x0f) + ((c > 0x40) ? 9 : 0);
+			value[i / BIG_INTEGER_NUM_NIBBLES] |= nibble << (4 * (i % BIG_INTEGER_NUM_NIBBLES));
+		}
+	} else
+		fromHex(std::string_view(str, length));
+}
+
+/*
+ * Constructor: from a BigInteger of another width
+ * The lower words are copied, a wider value is truncated and a
+ * narrower one is zero-extended.
+ * @param other the BigInteger to convert
+ */
+template <unsigned int Bits>
+template <unsigned int OtherBits>
+constexpr BigInteger<Bits>::BigInteger(const BigInteger<OtherBits> &other) : value{}
+{
+	for (int i=0; i<WORDS; i++)
+		value[i] = (i < BigInteger<OtherBits>::WORDS) ? other.value[i] : 0;
+}
+
+//---------------------------------------------------------------
+/*
+ * adds a given BigInteger to *this
+ * The value array is processed word by word. Every step a word
+ * of the given BigInteger is added to the corresponding word of
+ * *this. If the result of the addition is smaller than the word
+ * an overflow occured.
+ * The carry of the last step is added to *this. If the carry is
+ * greater than the result of the addition an overflow occured.
+ * If an overflow occured, the carry is stored to be
+ * added in the next step.
+ * @param addend a BigInteger to be added to *this
+ */
+template <unsigned int Bits>
+constexpr BigInteger<Bits>& BigInteger<Bits>::addc(const BigInteger &addend)
+{	// Multi-precision addition: carry handling is important
+	bigIntType carry_next = 0, carry = 0;
+	BIG_INTEGER_UNROLL
+	for (int i=0; i<WORDS; i++) 
+    {
+		carry_next = addend.value[i];				// prevent errors if addend = *this
+        value[i] += addend.value[i];
+		carry_next = value[i] < carry_next;			// Did addition produce an overflow?
+	    value[i] += carry;							// Add carry from last iteration
+		carry = carry_next || (value[i] < carry);	// Did addition of carry produce an overflow?
+ 	}
+	return *this;
+}
+
+//---------------------------------------------------------------
+/*
+ * Equality of two word arrays of n words with SSE2: the XOR of each
+ * 16-byte pair is ORed into one register, which is compared with zero
+ * once at the end. The three loads of a 48-byte BigInteger<> need no
+ * branch per word.
+ */
+inline bool bigIntegerEqualWords(const bigIntType *a, const bigIntType *b, int n)
+{
+	bigIntType diff = 0;
+	int i = 0;
+#if defined(__SSE2__)
+	__m128i diff128 = _mm_setzero_si128();
+	for (; i+2<=n; i+=2)
+		diff128 = _mm_or_si128(diff128, _mm_xor_si128(_mm_loadu_si128((const __m128i *)(a+i)),
+		                                              _mm_loadu_si128((const __m128i *)(b+i))));
+	diff = (bigIntType)_mm_movemask_epi8(_mm_cmpeq_epi8(diff128, _mm_setzero_si128())) ^ 0xffff;
+#endif
+	for (; i<n; i++)
+		diff |= a[i] ^ b[i];
+	return diff == 0;
+}
+
+/*
+ * Compares two BigInteger instances
+ * returns true if both instances are equal
+ * At runtime all words are checked at once with
+ * bigIntegerEqualWords(), in a constant expression word by word.
+ */
+template <unsigned int Bits>
+constexpr bool BigInteger<Bits>::compare(const BigInteger &testme) const
+{
+	if (!BIG_INTEGER_CONSTANT_EVALUATED())
+		return bigIntegerEqualWords(value, testme.value, WORDS);
+	for (int c=0; c < WORDS; ++c)
+	{
+		if (value[c] != testme.value[c])
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Three-way comparison of two BigInteger instances
+ * The words are compared from the most significant one down, the
+ * first differing word decides.
+ * @return -1 if *this < other, 0 if equal, 1 if *this > other
+ */
+template <unsigned int Bits>
+constexpr int BigInteger<Bits>::compareTo(const BigInteger &other) const
+{
+	for (int i=WORDS-1; i>=0; i--)
+		if (value[i] != other.value[i])
+			return (value[i] < other.value[i]) ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Hash value of all words: every word is mixed in with a multiply
+ * by the 64-bit golden ratio and a xor-shift, so equal values give
+ * equal hashes and nearby values spread over all bits.
+ */
+template <unsigned int Bits>
+constexpr size_t BigInteger<Bits>::hash() const
+{
+	bigIntType h = 0;
+	BIG_INTEGER_UNROLL
+	for (int i=0; i<WORDS; i++) {
+		h = (h ^ value[i]) * 0x9E3779B97F4A7C15ULL;
+		h ^= h >> 32;
+	}
+	return (size_t)h;
+}
+
+// Comparison operators, for sorting and as key of ordered containers
+template <unsigned int Bits>
+constexpr bool operator == (const BigInteger<Bits> &a, const BigInteger<Bits> &b) { return a.compare(b); }
+template <unsigned int Bits>
+constexpr bool operator != (const BigInteger<Bits> &a, const BigInteger<Bits> &b) { return !a.compare(b); }
+template <unsigned int Bits>
+constexpr bool operator < (const BigInteger<Bits> &a, const BigInteger<Bits> &b) { return a.compareTo(b) < 0; }
+template <unsigned int Bits>
+constexpr bool operator <= (const BigInteger<Bits> &a, const BigInteger<Bits> &b) { return a.compareTo(b) <= 0; }
+template <unsigned int Bits>
+constexpr bool operator > (const BigInteger<Bits> &a, const BigInteger<Bits> &b) { return a.compareTo(b) > 0; }
+template <unsigned int Bits>
+constexpr bool operator >= (const BigInteger<Bits> &a, const BigInteger<Bits> &b) { return a.compareTo(b) >= 0; }
+
+// Hash of a BigInteger for unordered containers, see BigInteger::hash()
+namespace std {
+template <unsigned int Bits>
+struct hash<BigInteger<Bits> > {
+	size_t operator () (const BigInteger<Bits> &v) const { return v.hash(); }
+};
+}
+
+//---------------------------------------------------------------
+/*
+ * Funnel shifts of the word pair (hi,lo) by 0 <= n < 64 bits:
+ * the upper word of (hi,lo) << n and the lower word of (hi,lo) >> n.
+ * Written as a 128-bit shift the compiler emits one SHLD or SHRD
+ * on x86-64. The portable form shifts by 1 and 63 - n instead of
+ * 64 - n, which would be undefined for n = 0.
+ */
+constexpr inline bigIntType bigIntegerFunnelLeft(bigIntType hi, bigIntType lo, unsigned int n)
+{
+#if defined(__SIZEOF_INT128__)
+	return (bigIntType)(((((unsigned __int128)hi << 64) | lo) << n) >> 64);
+#else
+	return (hi << n) | ((lo >> 1) >> (63 - n));
+#endif
+}
+
+constexpr inline bigIntType bigIntegerFunnelRight(bigIntType hi, bigIntType lo, unsigned int n)
+{
+#if defined(__SIZEOF_INT128__)
+	return (bigIntType)((((unsigned __int128)hi << 64) | lo) >> n);
+#else
+	return (lo >> n) | ((hi << 1) << (63 - n));
+#endif
+}
+
+/*
+ * shifts *this val times to the left, see below
+ * @param val defines shifting dimension.
+ */
+template <unsigned int Bits>
+constexpr BigInteger<Bits>& BigInteger<Bits>::shiftLeft(unsigned int val)
+{
+	return shiftLeft(*this, val);
+}
+
+/*
+ * Sets *this to src shifted val times to the left.
+ * val splits into a word distance w and a bit distance b. Every
+ * result word is the funnel shift of the two source words w and w+1
+ * below it, so word and bit shift happen in one pass. The words are
+ * written from the top down and only read at or below the written
+ * position, so src may be *this. Bits above the width are lost, the
+ * lower words are filled with 0.
+ * @param src the value to shift
+ * @param val defines shifting dimension.
+ */
+template <unsigned int Bits>
+constexpr BigInteger<Bits>& BigInteger<Bits>::shiftLeft(const BigInteger &src, unsigned int val)
+{	// Multi-precision shift-left
+	const int w = (val / BIG_INTEGER_WORD_BITS < (unsigned int)WORDS) ? (int)(val / BIG_INTEGER_WORD_BITS) : WORDS;
+	const unsigned int b = val % BIG_INTEGER_WORD_BITS;
+	BIG_INTEGER_UNROLL
+	for (int j=WORDS-1; j>=0; j--) {
+		bigIntType hi = (j-w >= 0) ? src.value[j-w] : 0;
+		bigIntType lo = (j-w-1 >= 0) ? src.value[j-w-1] : 0;
+		value[j] = bigIntegerFunnelLeft(hi, lo, b);
+	}
+	return *this;
+}
+
+/*
+ * shifts *this val times to the right, see below
+ * @param val defines shifting dimension.
+ */
+template <unsigned int Bits>
+constexpr BigInteger<Bits>& BigInteger<Bits>::shiftRight(unsigned int val)
+{
+	return shiftRight(*this, val);
+}
+
+/*
+ * Sets *this to src shifted val times to the right.
+ * The mirror image of shiftLeft(): the words are written from the
+ * bottom up as funnel shifts of the source words w and w+1 above
+ * them. The upper words are filled with 0.
+ * @param src the value to shift, may be *this
+ * @param val defines shifting dimension.
+ */
+template <unsigned int Bits>
+constexpr BigInteger<Bits>& BigInteger<Bits>::shiftRight(const BigInteger &src, unsigned int val)
+{	// Multi-precision shift-right
+	const int w = (val / BIG_INTEGER_WORD_BITS < (unsigned int)WORDS) ? (int)(val / BIG_INTEGER_WORD_BITS) : WORDS;
+	const unsigned int b = val % BIG_INTEGER_WORD_BITS;
+	BIG_INTEGER_UNROLL
+	for (int j=0; j<WORDS; j++) {
+		bigIntType lo = (j+w < WORDS) ? src.value[j+w] : 0;
+		bigIntType hi = (j+w+1 < WORDS) ? src.value[j+w+1] : 0;
+		value[j] = bigIntegerFunnelRight(hi, lo, b);
+	}
+	return *this;
+}
+
+//---------------------------------------------------------------
+/*
+ * Bitwise AND, OR and XOR of *this with mask, word by word
+ */
+template <unsigned int Bits>
+constexpr BigInteger<Bits>& BigInteger<Bits>::bitAnd(const BigInteger &mask)
+{
+	BIG_INTEGER_UNROLL
+	for (int i=0; i<WORDS; i++)
+		value[i] &= mask.value[i];
+	return *this;
+}
+
+template <unsigned int Bits>
+constexpr BigInteger<Bits>& BigInteger<Bits>::bitOr(const BigInteger &mask)
+{
+	BIG_INTEGER_UNROLL
+	for (int i=0; i<WORDS; i++)
+		value[i] |= mask.value[i];
+	return *this;
+}
+
+template <unsigned int Bits>
+constexpr BigInteger<Bits>& BigInteger<Bits>::bitXor(const BigInteger &mask)
+{
+	BIG_INTEGER_UNROLL
+	for (int i=0; i<WORDS; i++)
+		value[i] ^= mask.value[i];
+	return *this;
+}
+
+/*
+ * Number of significant bits: the highest non-zero word is found
+ * from the top, its leading zeros are counted with one instruction
+ * (LZCNT or BSR on x86-64).
+ * @return position of the highest set bit + 1, 0 if *this is 0
+ */
+template <unsigned int Bits>
+constexpr int BigInteger<Bits>::bitLength() const
+{
+	for (int i=WORDS-1; i>=0; i--) {
+		if (value[i] != 0) {
+#if defined(__GNUC__)
+			return BIG_INTEGER_WORD_BITS * (i+1) - __builtin_clzll(value[i]);
+#else
+			int n = BIG_INTEGER_WORD_BITS * i;
+			for (bigIntType v = value[i]; v; v >>= 1)
+				n++;
+			return n;
+#endif
+		}
+	}
+	return 0;
+}
+
+/*
+ * Tests bit n, bit 0 is the least significant one
+ * @return false for n beyond the words
+ */
+template <unsigned int Bits>
+constexpr bool BigInteger<Bits>::testBit(unsigned int n) const
+{
+	return n < (unsigned int)(BIG_INTEGER_WORD_BITS * WORDS)
+	    && ((value[n / BIG_INTEGER_WORD_BITS] >> (n % BIG_INTEGER_WORD_BITS)) & 1);
+}
+
+//---------------------------------------------------------------
+/*
+ * Kernel signature of the 384-bit reductions mod p192:
+ * reduces the word array t[6] into r[3]
+ */
+typedef void (*bigIntegerReduce192Kernel)(bigIntType r[3], const bigIntType t[6]);
+
+/*
+ * Reduces a word array of any length mod p192 into r[3].
+ * Up to six words are handed to the 384-bit kernel at once. Longer
+ * arrays are reduced starting at the most significant end: the six
+ * top words first, then the intermediate result, which is below
+ * 2^192, is put above the next three lower words and reduced again
+ * (Horner scheme with three words per step).
+ */
+constexpr inline void bigIntegerReduceWords192(bigIntType r[3], const bigIntType *v, int words, bigIntegerReduce192Kernel reduce)
+{
+	bigIntType t[6] = {0,0,0,0,0,0};
+	int i = (words > 6) ? words - 6 : 0;
+	for (int j=0; i+j<words; j++)
+		t[j] = v[i+j];
+	reduce(r, t);
+	while (i > 0) {
+		const int step = (i > 3) ? 3 : i;
+		i -= step;
+		for (int j=0; j<3; j++)
+			t[j] = (j < step) ? v[i+j] : 0;
+		t[step] = r[0]; t[step+1] = r[1]; t[step+2] = r[2];
+		for (int j=step+3; j<6; j++)
+			t[j] = 0;
+		reduce(r, t);
+	}
+}
+
+/*
+ * Stores a reduced 192-bit result r[3] in the word array v
+ * and zeroes out the upper words.
+ */
+constexpr inline void bigIntegerStoreWords192(bigIntType *v, int words, const bigIntType r[3])
+{
+	for (int i=0; i<words; i++)
+		v[i] = (i < 3) ? r[i] : 0;
+}
+
+/*
+ * Adds a word to the two word accumulator (hi,lo).
+ * The carry out of lo is the result of the comparison, no branch.
+ */
+constexpr inline void bigIntegerAccumulate(bigIntType &lo, bigIntType &hi, bigIntType x)
+{
+	lo += x;
+	hi += (lo < x);
+}
+
+/*
+ * Solinas reduction of a 384-bit word array t[6] mod
+ * p192 = 2^192 - 2^64 - 1 into r[3], portable kernel.
+ * With 64-bit words the input is (a5,a4,a3,a2,a1,a0) and the
+ * result is T + S1 + S2 + S3 with
+ *	T  = (a2,a1,a0)    S1 = ( 0,a3,a3)
+ *	S2 = (a4,a4, 0)    S3 = (a5,a5,a5)
+ * All terms of a column are summed in one accumulator (hi,lo), the
+ * low word is the result word and hi is carried into the next column.
+ * The carries c out of bit 192 are folded back as (0,c,c) because
+ * 2^192 = 2^64 + 1 (mod p), a second fold catches the rare carry of
+ * the first one. Finally p is subtracted if the result is not below
+ * p: r + 2^64 + 1 carries out of bit 192 exactly when r >= p, and
+ * that carry is turned into a mask which selects r - p or r.
+ * The instruction sequence does not depend on the input.
+ * r may point to t.
+ */
+constexpr inline void bigIntegerReduce192c(bigIntType r[3], const bigIntType t[6])
+{	// Modular reduction mod p192 = 2^192 - 2^64 - 1
+	bigIntType lo = 0, hi = 0, r0 = 0, r1 = 0, r2 = 0, c = 0;
+
+	// T + S1 + S2 + S3
+	lo = t[0]; hi = 0;
+	bigIntegerAccumulate(lo, hi, t[3]);
+	bigIntegerAccumulate(lo, hi, t[5]);
+	r0 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, t[1]);
+	bigIntegerAccumulate(lo, hi, t[3]);
+	bigIntegerAccumulate(lo, hi, t[4]);
+	bigIntegerAccumulate(lo, hi, t[5]);
+	r1 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, t[2]);
+	bigIntegerAccumulate(lo, hi, t[4]);
+	bigIntegerAccumulate(lo, hi, t[5]);
+	r2 = lo; c = hi;
+
+	// first fold: + (0,c,c)
+	lo = r0; hi = 0;
+	bigIntegerAccumulate(lo, hi, c);
+	r0 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, r1);
+	bigIntegerAccumulate(lo, hi, c);
+	r1 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, r2);
+	r2 = lo; c = hi;
+
+	// second fold: + (0,c,c), cannot carry any more
+	lo = r0; hi = 0;
+	bigIntegerAccumulate(lo, hi, c);
+	r0 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, r1);
+	bigIntegerAccumulate(lo, hi, c);
+	r1 = lo;
+	r2 += hi;
+
+	// conditional subtraction of p: s = r + 2^64 + 1
+	bigIntType s0 = 0, s1 = 0, s2 = 0, mask = 0;
+	lo = r0; hi = 0;
+	bigIntegerAccumulate(lo, hi, 1);
+	s0 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, r1);
+	bigIntegerAccumulate(lo, hi, 1);
+	s1 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, r2);
+	s2 = lo;
+	mask = (bigIntType)0 - hi;					// all ones if r >= p
+	r[0] = (s0 & mask) | (r0 & ~mask);
+	r[1] = (s1 & mask) | (r1 & ~mask);
+	r[2] = (s2 & mask) | (r2 & ~mask);
+}
+
+/*
+ * Modular reduction mod p192 = 2^192 - 2^64 - 1
+ * Uses the portable kernel bigIntegerReduce192c().
+ */
+template <unsigned int Bits>
+constexpr BigInteger<Bits>& BigInteger<Bits>::modp192c()
+{	// Modular reduction mod p192 = 2^192 - 2^64 -1
+	bigIntType r[3] = {0,0,0};
+	bigIntegerReduceWords192(r, value, WORDS, bigIntegerReduce192c);
+	bigIntegerStoreWords192(value, WORDS, r);
+	return *this;
+}
+
+// Width-specific kernels, see BigInteger.cpp
+#if defined(__x86_64__)
+template <> BigInteger<192>& BigInteger<192>::adda(const BigInteger<192> &addend);
+template <> BigInteger<256>& BigInteger<256>::adda(const BigInteger<256> &addend);
+template <> BigInteger<384>& BigInteger<384>::adda(const BigInteger<384> &addend);
+#endif
+
 // Input- and output operators
-ostream& operator << (ostream& outstr, const BigInteger &bigint);
+template <unsigned int Bits>
+ostream& operator << (ostream& outstr, const BigInteger<Bits> &bigint);
+
+//---------------------------------------------------------------
+/*
+ * Checks the characters of a _big literal: 0x or 0X and hexadecimal
+ * digits, or decimal digits without a leading zero. The octal (017)
+ * and binary (0b101) forms and floating-point literals would give a
+ * wrong value, they are rejected. Digit separators ' are allowed.
+ */
+template <char... Digits>
+constexpr bool bigIntegerLiteralValid()
+{
+	const char digits[] = {Digits..., '\0'};
+	const bool hex = digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X');
+	if (!hex && digits[0] == '0' && digits[1] != '\0')
+		return false;
+	size_t i = hex ? 2 : 0;
+	if (!digits[i])
+		return false;
+	for (; digits[i]; i++) {
+		const char c = digits[i];
+		const bool decimal = c >= '0' && c <= '9';
+		const bool letter = (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+		if (!(decimal || (hex && letter) || c == '\''))
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Literal of a BigInteger<>: 0x...FF_big in hexadecimal or 123_big in
+ * decimal, digit separators ' are skipped. The value is built at
+ * compile time, digits above the width are lost. Other forms do not
+ * compile, see bigIntegerLiteralValid().
+ */
+template <char... Digits>
+constexpr BigInteger<> operator "" _big()
+{
+	static_assert(bigIntegerLiteralValid<Digits...>(),
+	              "_big takes 0x hexadecimal or decimal integers, no octal, binary or floating-point literals");
+	const char digits[] = {Digits..., '\0'};
+	const bool hex = digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X');
+	BigInteger<> result;
+	for (size_t i = hex ? 2 : 0; digits[i]; i++) {
+		char c = digits[i];
+		if (c == '\'')
+			continue;
+		if (hex) {
+			result.shiftLeft(4);
+		} else {
+			BigInteger<> times2 = result;
+			result.shiftLeft(3).addc(times2.shiftLeft(1));
+		}
+		result.addc(BigInteger<>((bigIntType)((c & 0x0f) + ((c > 0x40) ? 9 : 0))));
+	}
+	return result;
+}
 
 // some BigInteger constants: 0, 1
-static const BigInteger BIG0, BIG1(1);
+inline constexpr BigInteger<> BIG0, BIG1(1);
 
 #endif	// __BIG_INTEGER_H_
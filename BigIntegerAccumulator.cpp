@@ -0,0 +1,67 @@
+#include "BigIntegerAccumulator.h"
+
+//---------------------------------------------------------------
+/*
+ * Constructor
+ * The sum starts at zero
+ */
+BigIntegerAccumulator::BigIntegerAccumulator(void)
+{
+	terms = 0;
+}
+
+/*
+ * Sets the sum to zero
+ */
+void BigIntegerAccumulator::clear()
+{
+	sum = BigInteger<384>();
+	terms = 0;
+}
+
+/*
+ * Adds a 192-bit term to the sum, no reduction.
+ * The term is added to the lower three words, the carry out of
+ * them goes to word 3. With fewer than 2^64 terms the sum is below
+ * 2^256, so word 3 cannot overflow and the upper words stay zero.
+ * Before the term counter would wrap the sum is reduced.
+ * @param term any 192-bit value, it does not have to be reduced
+ */
+BigIntegerAccumulator& BigIntegerAccumulator::add(const BigInteger<192> &term)
+{	// Multi-precision addition: carry handling is important
+	if (terms == ~(bigIntType)0)
+		reduce();
+	bigIntType carry_next, carry = 0;
+	for (int i=0; i<3; i++) {
+		carry_next = term.value[i];
+		sum.value[i] += term.value[i];
+		carry_next = sum.value[i] < carry_next;		// Did addition produce an overflow?
+		sum.value[i] += carry;						// Add carry from last word
+		carry = carry_next | (sum.value[i] < carry);	// Did addition of carry produce an overflow?
+	}
+	sum.value[3] += carry;
+	terms++;
+	return *this;
+}
+
+/*
+ * Reduces the sum mod p192 = 2^192 - 2^64 - 1.
+ * The 384-bit value[] is exactly the input of the reduction kernel,
+ * so one kernel call gives the fully reduced sum. It counts as one
+ * term afterwards.
+ */
+BigIntegerAccumulator& BigIntegerAccumulator::reduce()
+{
+	sum.modp192();
+	terms = 1;
+	return *this;
+}
+
+/*
+ * Returns the sum mod p192, fully reduced
+ */
+BigInteger<192> BigIntegerAccumulator::result()
+{
+	reduce();
+	return BigInteger<192>(sum);
+}
@@ -0,0 +1,29 @@
+#ifndef __BIG_INTEGER_ACCUMULATOR_H_
+#define __BIG_INTEGER_ACCUMULATOR_H_
+
+#include "BigInteger.h"
+
+//---------------------------------------------------------------
+/*
+ * Accumulator for sums of 192-bit terms mod p192
+ * The sum is kept unreduced in the 384-bit value[] of a
+ * BigInteger<384>: the terms are added into the lower three words
+ * and their carries collect in the spare upper words. After n terms
+ * the sum is below n * 2^192, so it fits as long as fewer than 2^64
+ * terms were added since the last reduction. The Solinas reduction
+ * runs only when that headroom runs out or the result is read.
+ */
+class BigIntegerAccumulator
+{
+private:
+	BigInteger<384> sum;						// unreduced sum
+	bigIntType terms;							// terms added since the last reduction
+public:
+	BigIntegerAccumulator(void);				// constructor, the sum is 0
+	BigIntegerAccumulator& add(const BigInteger<192> &term);	// add a term without reduction
+	BigIntegerAccumulator& reduce();			// reduce the sum mod p192
+	BigInteger<192> result();					// reduced sum mod p192
+	void clear();								// set the sum to 0
+};
+
+#endif	// __BIG_INTEGER_ACCUMULATOR_H_
@@ -0,0 +1,88 @@
+#include "BigIntegerArena.h"
+#include <new>
+
+//---------------------------------------------------------------
+/*
+ * Constructor
+ * All free lists are empty, the first allocation takes a chunk.
+ */
+BigIntegerArena::BigIntegerArena(void)
+{
+	for (int i=0; i<BIG_INTEGER_ARENA_CLASSES; i++)
+		freeList[i] = 0;
+	top = 0;
+	left = 0;
+	heapWords = 0;
+}
+
+/*
+ * Destructor: frees all chunks, every block handed out becomes invalid
+ */
+BigIntegerArena::~BigIntegerArena(void)
+{
+	for (size_t i=0; i<chunks.size(); i++)
+		::operator delete(chunks[i], std::align_val_t(64));
+}
+
+//---------------------------------------------------------------
+/*
+ * Hands out a block of the smallest size class that holds words.
+ * A block from the free list of the class is taken first, otherwise
+ * the block is cut from the current chunk. If the chunk is too short
+ * a new one is taken from the heap, its rest is lost, it is below
+ * the block size.
+ * @param words the words needed, at most the largest class, set to
+ *	the size of the block
+ * @return the block, 64-byte aligned
+ */
+bigIntType *BigIntegerArena::allocate(int &words)
+{
+	int sizeClass = 0;
+	size_t size = BIG_INTEGER_ARENA_MIN_WORDS;
+	while (size < (size_t)words && sizeClass < BIG_INTEGER_ARENA_CLASSES-1) {
+		size <<= 1;
+		sizeClass++;
+	}
+	words = (int)size;
+
+	if (freeList[sizeClass] != 0) {
+		freeBlock *block = freeList[sizeClass];
+		freeList[sizeClass] = block->next;
+		return reinterpret_cast<bigIntType *>(block);
+	}
+	if (left < size) {
+		size_t chunkWords = (size > BIG_INTEGER_ARENA_CHUNK_WORDS) ? size : BIG_INTEGER_ARENA_CHUNK_WORDS;
+		top = static_cast<bigIntType *>(::operator new(chunkWords * sizeof(bigIntType), std::align_val_t(64)));
+		chunks.push_back(top);
+		left = chunkWords;
+		heapWords += chunkWords;
+	}
+	bigIntType *block = top;
+	top += size;
+	left -= size;
+	return block;
+}
+
+/*
+ * Puts a block on the free list of its size class
+ * @param words the size set by allocate()
+ */
+void BigIntegerArena::release(bigIntType *block, int words)
+{
+	int sizeClass = 0;
+	while (((size_t)BIG_INTEGER_ARENA_MIN_WORDS << sizeClass) < (size_t)words)
+		sizeClass++;
+	freeBlock *link = reinterpret_cast<freeBlock *>(block);
+	link->next = freeList[sizeClass];
+	freeList[sizeClass] = link;
+}
+
+/*
+ * Arena of the calling thread, created on first use and destroyed
+ * when the thread ends
+ */
+BigIntegerArena &BigIntegerArena::local()
+{
+	static thread_local BigIntegerArena arena;
+	return arena;
+}
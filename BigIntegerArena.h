@@ -0,0 +1,54 @@
+#ifndef __BIG_INTEGER_ARENA_H_
+#define __BIG_INTEGER_ARENA_H_
+
+#include <stddef.h>
+#include <vector>
+#include "BigInteger.h"
+
+// Smallest block in words, the size classes double from here
+#define BIG_INTEGER_ARENA_MIN_WORDS 8
+
+// Number of size classes, the largest block has 8 * 2^23 words
+#define BIG_INTEGER_ARENA_CLASSES 24
+
+// Words requested from the heap at once, 64 KiB
+#define BIG_INTEGER_ARENA_CHUNK_WORDS 8192
+
+//---------------------------------------------------------------
+/*
+ * Pool of word blocks for BigIntegerVar
+ * Blocks come in power-of-two size classes. A released block is put
+ * on the free list of its class and handed out again by the next
+ * allocation of that class, so the temporaries of a computation are
+ * recycled and the heap is only asked for new chunks while the
+ * working set grows. Blocks are cut from the chunks by bumping a
+ * pointer, a block wider than a chunk gets a chunk of its own. The
+ * chunks are freed by the destructor only.
+ * An arena is not synchronized: every thread uses its own, local()
+ * gives the arena of the calling thread.
+ */
+class BigIntegerArena
+{
+private:
+	// A block on a free list holds the link to the next one
+	struct freeBlock {
+		freeBlock *next;
+	};
+	freeBlock *freeList[BIG_INTEGER_ARENA_CLASSES];
+	std::vector<bigIntType *> chunks;			// all memory taken from the heap
+	bigIntType *top;							// unused rest of the current chunk
+	size_t left;								// words left at top
+	size_t heapWords;							// words taken from the heap
+	BigIntegerArena(const BigIntegerArena &);	// no copies
+	BigIntegerArena& operator = (const BigIntegerArena &);
+public:
+	BigIntegerArena(void);						// constructor, nothing is allocated yet
+	~BigIntegerArena(void);						// destructor, frees all chunks
+	bigIntType *allocate(int &words);			// block of at least words, words is set to its size
+	void release(bigIntType *block, int words);	// give back a block of allocate()
+	size_t chunkCount() const { return chunks.size(); }	// chunks taken from the heap
+	size_t heapBytes() const { return heapWords * sizeof(bigIntType); }	// bytes taken from the heap
+	static BigIntegerArena &local();			// arena of the calling thread
+};
+
+#endif	// __BIG_INTEGER_ARENA_H_
@@ -0,0 +1,431 @@
+#include "BigIntegerBatch.h"
+#include <new>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+//---------------------------------------------------------------
+/*
+ * Constructor
+ * Allocates the word array for the given number of lanes, padded
+ * to whole blocks of BIG_INTEGER_BATCH_LANES, and zeroes it out.
+ * @param lanes number of values in the batch
+ */
+template <unsigned int Bits>
+BigIntegerBatch<Bits>::BigIntegerBatch(size_t lanes)
+{
+	count = lanes;
+	stride = (lanes + BIG_INTEGER_BATCH_LANES - 1) / BIG_INTEGER_BATCH_LANES * BIG_INTEGER_BATCH_LANES;
+	limbs = static_cast<bigIntType *>(::operator new(stride * WORDS * sizeof(bigIntType), std::align_val_t(64)));
+	for (size_t i=0; i<stride * WORDS; i++)
+		limbs[i] = 0;
+}
+
+/*
+ * Destructor: frees the word array
+ */
+template <unsigned int Bits>
+BigIntegerBatch<Bits>::~BigIntegerBatch(void)
+{
+	::operator delete(limbs, std::align_val_t(64));
+}
+
+/*
+ * Stores a BigInteger in the given lane
+ */
+template <unsigned int Bits>
+void BigIntegerBatch<Bits>::set(size_t lane, const BigInteger<Bits> &val)
+{
+	for (int w=0; w<WORDS; w++)
+		limbs[w * stride + lane] = val.value[w];
+}
+
+/*
+ * Reads the BigInteger of the given lane
+ */
+template <unsigned int Bits>
+BigInteger<Bits> BigIntegerBatch<Bits>::get(size_t lane) const
+{
+	BigInteger<Bits> val;
+	for (int w=0; w<WORDS; w++)
+		val.value[w] = limbs[w * stride + lane];
+	return val;
+}
+
+//---------------------------------------------------------------
+/*
+ * Instruction set used by the batch kernels, derived from the
+ * variant selected by the runtime dispatch in BigInteger.cpp
+ */
+enum batchIsa { BATCH_PORTABLE, BATCH_AVX2, BATCH_AVX512 };
+
+static batchIsa selectedBatchIsa()
+{
+	static const batchIsa isa =
+		(bigIntegerSelectedIsa() >= BIG_INTEGER_ISA_AVX512) ? BATCH_AVX512 :
+		(bigIntegerSelectedIsa() >= BIG_INTEGER_ISA_AVX2) ? BATCH_AVX2 : BATCH_PORTABLE;
+	return isa;
+}
+
+//---------------------------------------------------------------
+/*
+ * Portable kernels, one block of BIG_INTEGER_BATCH_LANES lanes.
+ * The lane loops are innermost so the compiler may vectorize them.
+ * v points to word 0 of the first lane of the block.
+ */
+static void addBlock(bigIntType *v, const bigIntType *a, size_t stride, int words)
+{
+	bigIntType carry[BIG_INTEGER_BATCH_LANES] = {0};
+	for (int w=0; w<words; w++) {
+		for (int i=0; i<BIG_INTEGER_BATCH_LANES; i++) {
+			bigIntType addend = a[w * stride + i];
+			bigIntType sum = v[w * stride + i] + addend;
+			bigIntType carry_next = sum < addend;		// Did addition produce an overflow?
+			sum += carry[i];							// Add carry from last word
+			carry[i] = carry_next | (sum < carry[i]);	// Did addition of carry produce an overflow?
+			v[w * stride + i] = sum;
+		}
+	}
+}
+
+static void compareBlock(const bigIntType *v, const bigIntType *a, size_t stride, int words, bool equal[])
+{
+	bigIntType diff[BIG_INTEGER_BATCH_LANES] = {0};
+	for (int w=0; w<words; w++)
+		for (int i=0; i<BIG_INTEGER_BATCH_LANES; i++)
+			diff[i] |= v[w * stride + i] ^ a[w * stride + i];
+	for (int i=0; i<BIG_INTEGER_BATCH_LANES; i++)
+		equal[i] = (diff[i] == 0);
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+//---------------------------------------------------------------
+/*
+ * AVX2 kernels, four lanes per vector.
+ * AVX2 has no unsigned 64-bit compare: both operands get their sign
+ * bit flipped and are compared signed. The comparison yields all
+ * ones (-1) in a lane with carry, which is subtracted to count it.
+ */
+#define TARGET_AVX2 __attribute__((target("avx2")))
+
+TARGET_AVX2 static inline __m256i carryAvx2(__m256i sum, __m256i x)
+{	// all ones in every lane where sum < x (unsigned)
+	const __m256i sign = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+	return _mm256_cmpgt_epi64(_mm256_xor_si256(x, sign), _mm256_xor_si256(sum, sign));
+}
+
+TARGET_AVX2 static inline void accumulateAvx2(__m256i &lo, __m256i &hi, __m256i x)
+{
+	lo = _mm256_add_epi64(lo, x);
+	hi = _mm256_sub_epi64(hi, carryAvx2(lo, x));
+}
+
+TARGET_AVX2 static void addAvx2(bigIntType *v, const bigIntType *a, size_t stride, int words)
+{
+	__m256i carry = _mm256_setzero_si256();			// 0 or -1 per lane
+	for (int w=0; w<words; w++) {
+		__m256i x = _mm256_loadu_si256((const __m256i *)(a + w * stride));
+		__m256i sum = _mm256_add_epi64(_mm256_loadu_si256((const __m256i *)(v + w * stride)), x);
+		__m256i carry_next = carryAvx2(sum, x);
+		sum = _mm256_sub_epi64(sum, carry);
+		carry = _mm256_or_si256(carry_next, _mm256_and_si256(carry, _mm256_cmpeq_epi64(sum, _mm256_setzero_si256())));
+		_mm256_storeu_si256((__m256i *)(v + w * stride), sum);
+	}
+}
+
+/*
+ * Solinas reduction of t[6] mod p192 into r[3], four lanes.
+ * Same column sums, folds and conditional subtraction as the
+ * portable bigIntegerReduce192c() in BigInteger.h.
+ */
+TARGET_AVX2 static void reduce192Avx2(__m256i r[3], const __m256i t[6])
+{
+	const __m256i one = _mm256_set1_epi64x(1);
+	__m256i lo, hi, r0, r1, r2, c;
+
+	// T + S1 + S2 + S3
+	lo = t[0]; hi = _mm256_setzero_si256();
+	accumulateAvx2(lo, hi, t[3]);
+	accumulateAvx2(lo, hi, t[5]);
+	r0 = lo; lo = hi; hi = _mm256_setzero_si256();
+	accumulateAvx2(lo, hi, t[1]);
+	accumulateAvx2(lo, hi, t[3]);
+	accumulateAvx2(lo, hi, t[4]);
+	accumulateAvx2(lo, hi, t[5]);
+	r1 = lo; lo = hi; hi = _mm256_setzero_si256();
+	accumulateAvx2(lo, hi, t[2]);
+	accumulateAvx2(lo, hi, t[4]);
+	accumulateAvx2(lo, hi, t[5]);
+	r2 = lo; c = hi;
+
+	// two folds: + (0,c,c)
+	for (int fold=0; fold<2; fold++) {
+		lo = r0; hi = _mm256_setzero_si256();
+		accumulateAvx2(lo, hi, c);
+		r0 = lo; lo = hi; hi = _mm256_setzero_si256();
+		accumulateAvx2(lo, hi, r1);
+		accumulateAvx2(lo, hi, c);
+		r1 = lo; lo = hi; hi = _mm256_setzero_si256();
+		accumulateAvx2(lo, hi, r2);
+		r2 = lo; c = hi;
+	}
+
+	// conditional subtraction of p: s = r + 2^64 + 1
+	__m256i s0, s1, s2;
+	lo = r0; hi = _mm256_setzero_si256();
+	accumulateAvx2(lo, hi, one);
+	s0 = lo; lo = hi; hi = _mm256_setzero_si256();
+	accumulateAvx2(lo, hi, r1);
+	accumulateAvx2(lo, hi, one);
+	s1 = lo; lo = hi; hi = _mm256_setzero_si256();
+	accumulateAvx2(lo, hi, r2);
+	s2 = lo;
+	__m256i mask = _mm256_sub_epi64(_mm256_setzero_si256(), hi);	// all ones if r >= p
+	r[0] = _mm256_blendv_epi8(r0, s0, mask);
+	r[1] = _mm256_blendv_epi8(r1, s1, mask);
+	r[2] = _mm256_blendv_epi8(r2, s2, mask);
+}
+
+/*
+ * Reduces four lanes of any word count mod p192 (Horner scheme like
+ * bigIntegerReduceWords192() in BigInteger.h) and stores the result.
+ */
+TARGET_AVX2 static void modp192Avx2(bigIntType *v, size_t stride, int words)
+{
+	__m256i t[6], r[3];
+	int i = (words > 6) ? words - 6 : 0;
+	for (int j=0; j<6; j++)
+		t[j] = (i+j < words) ? _mm256_loadu_si256((const __m256i *)(v + (i+j) * stride)) : _mm256_setzero_si256();
+	reduce192Avx2(r, t);
+	while (i > 0) {
+		i--;
+		t[0] = _mm256_loadu_si256((const __m256i *)(v + i * stride));
+		t[1] = r[0]; t[2] = r[1]; t[3] = r[2];
+		t[4] = _mm256_setzero_si256(); t[5] = _mm256_setzero_si256();
+		reduce192Avx2(r, t);
+	}
+	for (int w=0; w<words; w++)
+		_mm256_storeu_si256((__m256i *)(v + w * stride), (w < 3) ? r[w] : _mm256_setzero_si256());
+}
+
+TARGET_AVX2 static void compareAvx2(const bigIntType *v, const bigIntType *a, size_t stride, int words, bool equal[])
+{
+	__m256i eq = _mm256_set1_epi64x(-1);
+	for (int w=0; w<words; w++)
+		eq = _mm256_and_si256(eq, _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(v + w * stride)),
+		                                             _mm256_loadu_si256((const __m256i *)(a + w * stride))));
+	int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+	for (int i=0; i<4; i++)
+		equal[i] = (mask >> i) & 1;
+}
+
+//---------------------------------------------------------------
+/*
+ * AVX-512 kernels, eight lanes per vector.
+ * The unsigned compare yields a lane mask, the carry is counted with
+ * a masked add.
+ */
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+
+TARGET_AVX512 static inline void accumulateAvx512(__m512i &lo, __m512i &hi, __m512i x)
+{
+	const __m512i one = _mm512_set1_epi64(1);
+	lo = _mm512_add_epi64(lo, x);
+	hi = _mm512_mask_add_epi64(hi, _mm512_cmplt_epu64_mask(lo, x), hi, one);
+}
+
+TARGET_AVX512 static void addAvx512(bigIntType *v, const bigIntType *a, size_t stride, int words)
+{
+	const __m512i one = _mm512_set1_epi64(1);
+	__mmask8 carry = 0;
+	for (int w=0; w<words; w++) {
+		__m512i x = _mm512_loadu_si512(a + w * stride);
+		__m512i sum = _mm512_add_epi64(_mm512_loadu_si512(v + w * stride), x);
+		__mmask8 carry_next = _mm512_cmplt_epu64_mask(sum, x);
+		sum = _mm512_mask_add_epi64(sum, carry, sum, one);
+		carry = carry_next | (carry & _mm512_cmpeq_epi64_mask(sum, _mm512_setzero_si512()));
+		_mm512_storeu_si512(v + w * stride, sum);
+	}
+}
+
+/*
+ * Solinas reduction of t[6] mod p192 into r[3], eight lanes.
+ * See reduce192Avx2().
+ */
+TARGET_AVX512 static void reduce192Avx512(__m512i r[3], const __m512i t[6])
+{
+	const __m512i one = _mm512_set1_epi64(1);
+	__m512i lo, hi, r0, r1, r2, c;
+
+	// T + S1 + S2 + S3
+	lo = t[0]; hi = _mm512_setzero_si512();
+	accumulateAvx512(lo, hi, t[3]);
+	accumulateAvx512(lo, hi, t[5]);
+	r0 = lo; lo = hi; hi = _mm512_setzero_si512();
+	accumulateAvx512(lo, hi, t[1]);
+	accumulateAvx512(lo, hi, t[3]);
+	accumulateAvx512(lo, hi, t[4]);
+	accumulateAvx512(lo, hi, t[5]);
+	r1 = lo; lo = hi; hi = _mm512_setzero_si512();
+	accumulateAvx512(lo, hi, t[2]);
+	accumulateAvx512(lo, hi, t[4]);
+	accumulateAvx512(lo, hi, t[5]);
+	r2 = lo; c = hi;
+
+	// two folds: + (0,c,c)
+	for (int fold=0; fold<2; fold++) {
+		lo = r0; hi = _mm512_setzero_si512();
+		accumulateAvx512(lo, hi, c);
+		r0 = lo; lo = hi; hi = _mm512_setzero_si512();
+		accumulateAvx512(lo, hi, r1);
+		accumulateAvx512(lo, hi, c);
+		r1 = lo; lo = hi; hi = _mm512_setzero_si512();
+		accumulateAvx512(lo, hi, r2);
+		r2 = lo; c = hi;
+	}
+
+	// conditional subtraction of p: s = r + 2^64 + 1
+	__m512i s0, s1, s2;
+	lo = r0; hi = _mm512_setzero_si512();
+	accumulateAvx512(lo, hi, one);
+	s0 = lo; lo = hi; hi = _mm512_setzero_si512();
+	accumulateAvx512(lo, hi, r1);
+	accumulateAvx512(lo, hi, one);
+	s1 = lo; lo = hi; hi = _mm512_setzero_si512();
+	accumulateAvx512(lo, hi, r2);
+	s2 = lo;
+	__mmask8 mask = _mm512_test_epi64_mask(hi, hi);		// r >= p
+	r[0] = _mm512_mask_blend_epi64(mask, r0, s0);
+	r[1] = _mm512_mask_blend_epi64(mask, r1, s1);
+	r[2] = _mm512_mask_blend_epi64(mask, r2, s2);
+}
+
+/*
+ * Reduces eight lanes of any word count mod p192, see modp192Avx2()
+ */
+TARGET_AVX512 static void modp192Avx512(bigIntType *v, size_t stride, int words)
+{
+	__m512i t[6], r[3];
+	int i = (words > 6) ? words - 6 : 0;
+	for (int j=0; j<6; j++)
+		t[j] = (i+j < words) ? _mm512_loadu_si512(v + (i+j) * stride) : _mm512_setzero_si512();
+	reduce192Avx512(r, t);
+	while (i > 0) {
+		i--;
+		t[0] = _mm512_loadu_si512(v + i * stride);
+		t[1] = r[0]; t[2] = r[1]; t[3] = r[2];
+		t[4] = _mm512_setzero_si512(); t[5] = _mm512_setzero_si512();
+		reduce192Avx512(r, t);
+	}
+	for (int w=0; w<words; w++)
+		_mm512_storeu_si512(v + w * stride, (w < 3) ? r[w] : _mm512_setzero_si512());
+}
+
+TARGET_AVX512 static void compareAvx512(const bigIntType *v, const bigIntType *a, size_t stride, int words, bool equal[])
+{
+	__mmask8 eq = 0xff;
+	for (int w=0; w<words; w++)
+		eq &= _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(v + w * stride), _mm512_loadu_si512(a + w * stride));
+	for (int i=0; i<8; i++)
+		equal[i] = (eq >> i) & 1;
+}
+#endif
+
+//---------------------------------------------------------------
+/*
+ * Adds the given batch to *this lane by lane, the carry out of the
+ * most significant word is dropped like in BigInteger::addc().
+ * Both batches must have the same number of lanes.
+ * @param addend a batch to be added to *this
+ */
+template <unsigned int Bits>
+BigIntegerBatch<Bits>& BigIntegerBatch<Bits>::addc(const BigIntegerBatch &addend)
+{	// Multi-precision addition: carry handling is important
+	switch (selectedBatchIsa()) {
+#if defined(__x86_64__) && defined(__GNUC__)
+	case BATCH_AVX512:
+		for (size_t i=0; i<stride; i+=8)
+			addAvx512(limbs + i, addend.limbs + i, stride, WORDS);
+		break;
+	case BATCH_AVX2:
+		for (size_t i=0; i<stride; i+=4)
+			addAvx2(limbs + i, addend.limbs + i, stride, WORDS);
+		break;
+#endif
+	default:
+		for (size_t i=0; i<stride; i+=BIG_INTEGER_BATCH_LANES)
+			addBlock(limbs + i, addend.limbs + i, stride, WORDS);
+		break;
+	}
+	return *this;
+}
+
+/*
+ * Modular reduction mod p192 = 2^192 - 2^64 - 1 of every lane.
+ * The results are fully reduced and equal those of
+ * BigInteger::modp192c() on the single values.
+ */
+template <unsigned int Bits>
+BigIntegerBatch<Bits>& BigIntegerBatch<Bits>::modp192c()
+{	// Modular reduction mod p192 = 2^192 - 2^64 -1
+	switch (selectedBatchIsa()) {
+#if defined(__x86_64__) && defined(__GNUC__)
+	case BATCH_AVX512:
+		for (size_t i=0; i<stride; i+=8)
+			modp192Avx512(limbs + i, stride, WORDS);
+		break;
+	case BATCH_AVX2:
+		for (size_t i=0; i<stride; i+=4)
+			modp192Avx2(limbs + i, stride, WORDS);
+		break;
+#endif
+	default:
+		for (size_t i=0; i<count; i++)
+			set(i, get(i).modp192c());
+		break;
+	}
+	return *this;
+}
+
+/*
+ * Compares two batches lane by lane
+ * equal[i] is set to true if lane i of both batches is equal.
+ * @param equal array with size() entries
+ * @return the number of equal lanes
+ */
+template <unsigned int Bits>
+size_t BigIntegerBatch<Bits>::compare(const BigIntegerBatch &testme, bool equal[]) const
+{
+	bool block[BIG_INTEGER_BATCH_LANES];
+	size_t matches = 0;
+	for (size_t i=0; i<count; i+=BIG_INTEGER_BATCH_LANES) {
+		switch (selectedBatchIsa()) {
+#if defined(__x86_64__) && defined(__GNUC__)
+		case BATCH_AVX512:
+			compareAvx512(limbs + i, testme.limbs + i, stride, WORDS, block);
+			break;
+		case BATCH_AVX2:
+			compareAvx2(limbs + i, testme.limbs + i, stride, WORDS, block);
+			compareAvx2(limbs + i + 4, testme.limbs + i + 4, stride, WORDS, block + 4);
+			break;
+#endif
+		default:
+			compareBlock(limbs + i, testme.limbs + i, stride, WORDS, block);
+			break;
+		}
+		for (size_t j=0; j<BIG_INTEGER_BATCH_LANES && i+j<count; j++) {
+			equal[i+j] = block[j];
+			matches += block[j];
+		}
+	}
+	return matches;
+}
+
+//---------------------------------------------------------------
+/*
+ * Widths instantiated by this translation unit, see BigInteger.cpp
+ */
+template class BigIntegerBatch<192>;
+template class BigIntegerBatch<256>;
+template class BigIntegerBatch<384>;
+template class BigIntegerBatch<521>;
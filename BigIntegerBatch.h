@@ -0,0 +1,45 @@
+#ifndef __BIG_INTEGER_BATCH_H_
+#define __BIG_INTEGER_BATCH_H_
+
+#include <stddef.h>
+#include "BigInteger.h"
+
+// Number of lanes processed together, one AVX-512 or two AVX2 vectors
+#define BIG_INTEGER_BATCH_LANES 8
+
+//---------------------------------------------------------------
+/*
+ * Batch of independent BigInteger<Bits> values
+ * The words are stored structure-of-arrays: all words 0 first, then
+ * all words 1 and so on. Word w of lane i is found at
+ * limbs[w * stride + i]. stride is the lane count rounded up to a
+ * multiple of BIG_INTEGER_BATCH_LANES, the padding lanes are zero.
+ * The operations work on all lanes at once with AVX2 or AVX-512
+ * kernels if the runtime dispatch selected them, carries are
+ * tracked per lane. The widths 192, 256, 384 and 521 are
+ * instantiated in BigIntegerBatch.cpp.
+ */
+template <unsigned int Bits>
+class BigIntegerBatch
+{
+public:
+	// Number of 64-bit words per lane
+	static const int WORDS = BigInteger<Bits>::WORDS;
+private:
+	size_t count;								// number of lanes in use
+	size_t stride;								// distance between two words of a lane
+	bigIntType *limbs;							// the values, 64-byte aligned
+	BigIntegerBatch(const BigIntegerBatch &);	// no copies
+	BigIntegerBatch& operator = (const BigIntegerBatch &);
+public:
+	BigIntegerBatch(size_t lanes);				// constructor, all lanes are zero
+	~BigIntegerBatch(void);						// destructor
+	size_t size() const { return count; }		// number of lanes
+	void set(size_t lane, const BigInteger<Bits> &val);	// store a value in a lane
+	BigInteger<Bits> get(size_t lane) const;	// read a value from a lane
+	BigIntegerBatch& addc(const BigIntegerBatch &addend);	// lane-wise multi-precision addition
+	BigIntegerBatch& modp192c();				// lane-wise modular reduction
+	size_t compare(const BigIntegerBatch &testme, bool equal[]) const;	// lane-wise comparison
+};
+
+#endif	// __BIG_INTEGER_BATCH_H_
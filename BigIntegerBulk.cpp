@@ -0,0 +1,299 @@
+#include "BigIntegerBulk.h"
+#include "BigInteger.h"
+#include "BigIntegerStream.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//---------------------------------------------------------------
+/*
+ * One chunk of input lines and the formatted results
+ */
+struct bulkChunk {
+	const char *begin, *end;		// input, ends behind a newline or at the end of input
+	std::string output;				// reduced values, one per line
+	size_t values;					// number of values in the chunk
+	const char *invalid;			// first invalid line, 0 if none
+	bool done;						// output is complete
+};
+
+/*
+ * Chunk indices of one worker. The owner takes chunks from the
+ * front, thieves take them from the back.
+ */
+struct bulkQueue {
+	std::mutex lock;
+	std::deque<size_t> chunks;
+};
+
+/*
+ * Shared state of one bulk reduction
+ * The chunks behind the first one with an invalid line are not
+ * written, the workers skip them.
+ */
+struct bulkJob {
+	std::vector<bulkChunk> chunks;
+	std::vector<bulkQueue> queues;
+	std::atomic<size_t> firstInvalid;	// index of the first chunk with an invalid line
+	std::mutex doneLock;
+	std::condition_variable doneSignal;
+	bulkJob(unsigned int threads) : queues(threads), firstInvalid((size_t)-1) {}
+};
+
+//---------------------------------------------------------------
+#if defined(__SSE2__)
+/*
+ * Checks 16 characters at once: c - '0' < 10 or (c | 0x20) - 'a' < 6,
+ * the unsigned compares are done as signed ones offset by 0x80
+ */
+static inline bool hexDigits16(const char *s)
+{
+	__m128i c = _mm_loadu_si128((const __m128i *)s);
+	__m128i digit = _mm_cmplt_epi8(_mm_add_epi8(c, _mm_set1_epi8((char)(0x80 - '0'))), _mm_set1_epi8((char)(0x80 + 10)));
+	__m128i letter = _mm_cmplt_epi8(_mm_add_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8((char)(0x80 - 'a'))),
+	                                _mm_set1_epi8((char)(0x80 + 6)));
+	return _mm_movemask_epi8(_mm_or_si128(digit, letter)) == 0xffff;
+}
+#endif
+
+/*
+ * Checks that [first, last) holds hex digits only and fits into 384
+ * bits. fromHex() takes any character as a digit, so everything else
+ * has to be rejected before.
+ */
+static inline bool validLine(const char *first, const char *last)
+{
+	if (last - first > BigInteger<384>::HEX_CHARS)
+		return false;
+	unsigned int valid = 1;
+#if defined(__SSE2__)
+	for (; last - first >= 16; first += 16)
+		valid &= hexDigits16(first);
+#endif
+	for (; first < last; first++) {
+		const unsigned char c = *first;
+		valid &= ((unsigned char)(c - '0') < 10) | ((unsigned char)((c | 0x20) - 'a') < 6);	// no branch per digit
+	}
+	return valid;
+}
+
+/*
+ * Parses, reduces and formats all lines of [begin, end), see
+ * BigIntegerBulk.h
+ */
+size_t bigIntegerBulkReduceLines(const char *begin, const char *end, std::string &output, const char **invalid)
+{
+	if (invalid)
+		*invalid = 0;
+	const int digits = BigInteger<192>::HEX_CHARS;
+	output.reserve(output.size() + (end - begin) / 2 + digits + 1);
+	size_t values = 0;
+
+	char buf[digits + 1];
+	buf[digits] = '\n';
+	const char *line = begin;
+	while (line < end) {
+		const char *eol = (const char *)memchr(line, '\n', end - line);
+		if (!eol)
+			eol = end;
+		const char *first = line, *last = eol;
+		while (first < last && (*first == ' ' || *first == '\t'))
+			first++;
+		while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r'))
+			last--;
+		if (first < last && !(last - first >= 2 && first[0] == '/' && first[1] == '/')) {
+			if (!validLine(first, last)) {
+				if (invalid)
+					*invalid = line;
+				break;
+			}
+			BigInteger<384> v;
+			v.fromHex(std::string_view(first, last - first)).modp192();
+			BigInteger<192>(v).toHex(buf);
+			output.append(buf, digits + 1);
+			values++;
+		}
+		line = eol + 1;
+	}
+	return values;
+}
+
+/*
+ * Reduces the lines of chunk i into its own output, unless a chunk in
+ * front of it has an invalid line
+ */
+static void reduceChunk(bulkJob &job, size_t i)
+{
+	bulkChunk &chunk = job.chunks[i];
+	if (i > job.firstInvalid.load(std::memory_order_relaxed))
+		return;
+	chunk.values = bigIntegerBulkReduceLines(chunk.begin, chunk.end, chunk.output, &chunk.invalid);
+	size_t first = job.firstInvalid.load(std::memory_order_relaxed);
+	while (chunk.invalid && i < first && !job.firstInvalid.compare_exchange_weak(first, i, std::memory_order_relaxed))
+		;
+}
+
+/*
+ * Takes the next chunk: from the front of the own queue, else from
+ * the back of the other queues
+ * @return false if no chunk is left
+ */
+static bool nextChunk(bulkJob &job, unsigned int self, size_t &chunk)
+{
+	const unsigned int n = job.queues.size();
+	for (unsigned int k=0; k<n; k++) {
+		bulkQueue &q = job.queues[(self + k) % n];
+		std::lock_guard<std::mutex> guard(q.lock);
+		if (q.chunks.empty())
+			continue;
+		if (k == 0) {
+			chunk = q.chunks.front();
+			q.chunks.pop_front();
+		} else {
+			chunk = q.chunks.back();
+			q.chunks.pop_back();
+		}
+		return true;
+	}
+	return false;
+}
+
+static void worker(bulkJob &job, unsigned int self)
+{
+	size_t i;
+	while (nextChunk(job, self, i)) {
+		reduceChunk(job, i);
+		std::lock_guard<std::mutex> guard(job.doneLock);
+		job.chunks[i].done = true;
+		job.doneSignal.notify_one();
+	}
+}
+
+//---------------------------------------------------------------
+/*
+ * Reduces all values of the input, see BigIntegerBulk.h
+ */
+bool bigIntegerBulkReduce(const char *input, size_t size, FILE *out, unsigned int threads, bigIntegerBulkStats *stats)
+{
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads == 0)
+		threads = 1;
+
+	// split at line boundaries
+	bulkJob job(threads);
+	const char *end = input + size;
+	for (const char *begin = input; begin < end; ) {
+		const char *stop = (end - begin > BIG_INTEGER_BULK_CHUNK) ? begin + BIG_INTEGER_BULK_CHUNK : end;
+		const char *eol = (const char *)memchr(stop - 1, '\n', end - stop + 1);
+		stop = eol ? eol + 1 : end;
+		bulkChunk chunk = {begin, stop, std::string(), 0, 0, false};
+		job.chunks.push_back(chunk);
+		begin = stop;
+	}
+	if (threads > job.chunks.size() && !job.chunks.empty())
+		threads = job.chunks.size();
+
+	// equal, contiguous shares per worker
+	const size_t n = job.chunks.size();
+	for (unsigned int w=0; w<threads; w++)
+		for (size_t i=n*w/threads; i<n*(w+1)/threads; i++)
+			job.queues[w].chunks.push_back(i);
+
+	std::vector<std::thread> pool;
+	for (unsigned int w=0; w<threads; w++)
+		pool.push_back(std::thread(worker, std::ref(job), w));
+
+	// write the chunks in input order up to the first invalid line
+	bool ok = true;
+	const char *invalid = 0;
+	size_t values = 0;
+	for (size_t i=0; i<n; i++) {
+		std::unique_lock<std::mutex> guard(job.doneLock);
+		job.doneSignal.wait(guard, [&]{ return job.chunks[i].done; });
+		guard.unlock();
+		bulkChunk &chunk = job.chunks[i];
+		if (!invalid) {
+			if (ok && fwrite(chunk.output.data(), 1, chunk.output.size(), out) != chunk.output.size())
+				ok = false;
+			values += chunk.values;
+			invalid = chunk.invalid;
+		}
+		std::string().swap(chunk.output);
+	}
+	for (unsigned int w=0; w<threads; w++)
+		pool[w].join();
+	if (fflush(out) != 0)
+		ok = false;
+
+	if (stats) {
+		stats->values = values;
+		stats->chunks = n;
+		stats->threads = threads;
+		stats->invalidOffset = invalid ? invalid - input : 0;
+	}
+	if (ok && invalid) {
+		errno = EINVAL;
+		return false;
+	}
+	return ok;
+}
+
+/*
+ * Memory-maps the input file and reduces it, see BigIntegerBulk.h
+ */
+bool bigIntegerBulkReduceFile(const char *inputPath, const char *outputPath, unsigned int threads, bigIntegerBulkStats *stats)
+{
+	bool toStdout = strcmp(outputPath, "-") == 0;
+	FILE *out = toStdout ? stdout : fopen(outputPath, "wb");
+	if (!out)
+		return false;
+
+	bool ok;
+	if (strcmp(inputPath, "-") == 0) {
+		ok = fflush(out) == 0 && bigIntegerStreamReduce(STDIN_FILENO, fileno(out), threads, stats);
+	} else {
+		int fd = open(inputPath, O_RDONLY);
+		struct stat st;
+		void *map = MAP_FAILED;
+		ok = fd >= 0 && fstat(fd, &st) == 0;
+		if (ok && st.st_size == 0) {
+			ok = bigIntegerBulkReduce("", 0, out, threads, stats);
+		} else if (ok) {
+			map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			ok = map != MAP_FAILED;
+			if (ok) {
+				madvise(map, st.st_size, MADV_SEQUENTIAL);
+				ok = bigIntegerBulkReduce((const char *)map, st.st_size, out, threads, stats);
+			}
+		}
+		const int error = errno;		// of the failed step, the cleanup may change it
+		if (map != MAP_FAILED)
+			munmap(map, st.st_size);
+		if (fd >= 0)
+			close(fd);
+		errno = error;
+	}
+
+	if (!toStdout) {
+		const int error = errno;
+		if (fclose(out) != 0 && ok)
+			ok = false;
+		else
+			errno = error;
+	}
+	return ok;
+}
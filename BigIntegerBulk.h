@@ -0,0 +1,55 @@
+#ifndef __BIG_INTEGER_BULK_H_
+#define __BIG_INTEGER_BULK_H_
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+
+// Size of the input chunks handed to the workers, in bytes
+#define BIG_INTEGER_BULK_CHUNK (1 << 20)
+
+//---------------------------------------------------------------
+/*
+ * Bulk reduction of hexadecimal values mod p192
+ * The input has the format of testcases.txt: one value of up to
+ * 384 bits per line, empty lines and lines starting with "//" are
+ * skipped. Every value is parsed, reduced mod p192 and written as
+ * 48 hex digits per line, in input order. A line with anything but
+ * hex digits (and blanks around them) or with more than 96 digits is
+ * invalid: the reduction stops there, the results of the lines in
+ * front of it are written and it fails with errno EINVAL.
+ * The input is split at line boundaries into chunks of about
+ * BIG_INTEGER_BULK_CHUNK bytes. Every worker thread starts with an
+ * equal share of the chunks and steals from the others when its own
+ * share is done. The calling thread writes the finished chunks in
+ * order and releases their output.
+ */
+struct bigIntegerBulkStats {
+	size_t values;			// number of reduced values
+	size_t chunks;			// number of input chunks
+	unsigned int threads;	// number of worker threads
+	size_t invalidOffset;	// byte offset of the invalid line if errno is EINVAL
+};
+
+// Parses, reduces and formats the lines in [begin, end), appends the
+// results to output. Stops at the first invalid line, *invalid is set
+// to its start or to 0 if all lines are valid. Returns the number of
+// values.
+size_t bigIntegerBulkReduceLines(const char *begin, const char *end, std::string &output,
+                                 const char **invalid = 0);
+
+// Reduces the values in input[0..size) and writes them to out.
+// threads = 0 uses one worker per hardware thread.
+// Returns false if writing fails or a line is invalid (errno EINVAL,
+// stats->invalidOffset tells where).
+bool bigIntegerBulkReduce(const char *input, size_t size, FILE *out,
+                          unsigned int threads = 0, bigIntegerBulkStats *stats = 0);
+
+// Memory-maps the file inputPath and reduces it to outputPath,
+// "-" selects stdin or stdout. stdin cannot be mapped, it is reduced
+// by bigIntegerStreamReduce() while it is read. Returns false on I/O
+// errors and invalid lines, errno tells the reason.
+bool bigIntegerBulkReduceFile(const char *inputPath, const char *outputPath,
+                              unsigned int threads = 0, bigIntegerBulkStats *stats = 0);
+
+#endif	// __BIG_INTEGER_BULK_H_
@@ -0,0 +1,255 @@
+#ifndef __BIG_INTEGER_EXPR_H_
+#define __BIG_INTEGER_EXPR_H_
+
+#include "BigInteger.h"
+
+// Tag of the reduction mod p192 = 2^192 - 2^64 - 1: (a + b) % P192
+struct bigIntegerP192Tag {};
+inline constexpr bigIntegerP192Tag P192{};
+
+//---------------------------------------------------------------
+/*
+ * Non-mutating + and << on BigInteger<Bits>, fused into one pass
+ * An expression of + and << is a sum of shifted operands, because
+ * the shift distributes over the sum: (a + b) << s = (a << s) +
+ * (b << s). BigIntegerSum<Bits, Terms> holds the operands and their
+ * shifts, every + concatenates two term lists, so the whole
+ * expression stays one flat sum and nothing is computed before it is
+ * used. Then one loop over the result words adds the words of all
+ * terms of a column into a two-word accumulator (hi,lo), so there is
+ * a single carry chain and no temporary BigInteger.
+ * Converted to a BigInteger the sum is taken mod 2^(64 * WORDS) like
+ * the result of the in-place addc() and shiftLeft(). % P192 gives
+ * the exact sum mod p192 for every shift instead, no bit is lost.
+ * The terms refer to the operands, so an expression has to be used
+ * in the statement that builds it and must not be kept in an auto
+ * variable.
+ * Example:	r = (a + b + (c << 3)) % P192;
+ */
+template <unsigned int Bits, int Terms>
+class BigIntegerSum
+{
+	template <unsigned int, int> friend class BigIntegerSum;
+public:
+	// Number of 64-bit words of the operands
+	static const int WORDS = BigInteger<Bits>::WORDS;
+private:
+	const BigInteger<Bits> *operand[Terms];
+	unsigned int shift[Terms];
+public:
+	constexpr BigIntegerSum(const BigInteger<Bits> &x, unsigned int val) : operand{&x}, shift{val} {}	// x << val
+	template <int Left>
+	constexpr BigIntegerSum(const BigIntegerSum<Bits, Left> &left, const BigIntegerSum<Bits, Terms - Left> &right);	// left + right
+	constexpr BigIntegerSum shiftedLeft(unsigned int val) const;	// the sum << val
+	constexpr void words(bigIntType t[], int n) const;	// lowest n words of the sum
+	constexpr operator BigInteger<Bits>() const;	// the sum mod 2^(64 * WORDS)
+	constexpr BigInteger<Bits> modp192() const;	// the sum mod p192
+private:
+	constexpr BigInteger<Bits> modp192Folded() const;	// modp192() with shifts above 128
+	template <int N> constexpr BigInteger<Bits> reduced() const;	// the sum over N words mod p192
+};
+
+/*
+ * Constructor: concatenates the terms of two sums
+ */
+template <unsigned int Bits, int Terms>
+template <int Left>
+constexpr BigIntegerSum<Bits, Terms>::BigIntegerSum(const BigIntegerSum<Bits, Left> &left,
+                                                    const BigIntegerSum<Bits, Terms - Left> &right) : operand{}, shift{}
+{
+	for (int k=0; k<Left; k++) {
+		operand[k] = left.operand[k];
+		shift[k] = left.shift[k];
+	}
+	for (int k=Left; k<Terms; k++) {
+		operand[k] = right.operand[k - Left];
+		shift[k] = right.shift[k - Left];
+	}
+}
+
+/*
+ * The sum shifted to the left: every term is shifted
+ */
+template <unsigned int Bits, int Terms>
+constexpr BigIntegerSum<Bits, Terms> BigIntegerSum<Bits, Terms>::shiftedLeft(unsigned int val) const
+{
+	BigIntegerSum sum(*this);
+	for (int k=0; k<Terms; k++)
+		sum.shift[k] += val;
+	return sum;
+}
+
+/*
+ * Computes the lowest n words of the sum in one pass
+ * Word i of a term x << s is the funnel shift of the words j and
+ * j-1 of x, j = i - s / 64, words outside of x are zero. All terms
+ * of a column are added to the accumulator (hi,lo), lo is the result
+ * word and hi is carried into the next column.
+ */
+template <unsigned int Bits, int Terms>
+constexpr void BigIntegerSum<Bits, Terms>::words(bigIntType t[], int n) const
+{
+	bigIntType lo = 0, hi = 0;
+	BIG_INTEGER_UNROLL
+	for (int i=0; i<n; i++) {
+		BIG_INTEGER_UNROLL
+		for (int k=0; k<Terms; k++) {
+			const int j = i - (int)(shift[k] / BIG_INTEGER_WORD_BITS);
+			const bigIntType upper = (j >= 0 && j < WORDS) ? operand[k]->value[j] : 0;
+			const bigIntType lower = (j >= 1 && j <= WORDS) ? operand[k]->value[j-1] : 0;
+			bigIntegerAccumulate(lo, hi, bigIntegerFunnelLeft(upper, lower, shift[k] % BIG_INTEGER_WORD_BITS));
+		}
+		t[i] = lo;
+		lo = hi;
+		hi = 0;
+	}
+}
+
+/*
+ * Evaluates the sum into a BigInteger, mod 2^(64 * WORDS)
+ */
+template <unsigned int Bits, int Terms>
+constexpr BigIntegerSum<Bits, Terms>::operator BigInteger<Bits>() const
+{
+	BigInteger<Bits> r;
+	words(r.value, WORDS);
+	return r;
+}
+
+/*
+ * Evaluates the sum mod p192
+ * A term shifted by s <= 128 bits is below 2^(64 * WORDS + s), so the
+ * sum of the terms is below 2^(64 * (WORDS + 2)) if s plus the bits
+ * of Terms stays within 128, else within WORDS + 3 words. It is
+ * summed over as many words and reduced by bigIntegerReduceWords192()
+ * with the portable kernel. Inlined into the summation it measured
+ * faster than the indirect call of the selected kernel: 28 instead of
+ * 46 cycles for three 192-bit terms. A term with a larger shift is
+ * reduced on its own first, see modp192Folded().
+ */
+template <unsigned int Bits, int Terms>
+constexpr BigInteger<Bits> BigIntegerSum<Bits, Terms>::modp192() const
+{
+	unsigned int top = 0;
+	for (int k=0; k<Terms; k++)
+		if (shift[k] > top)
+			top = shift[k];
+	if (top > 128)
+		return modp192Folded();
+	int carryBits = 0;
+	while ((1 << carryBits) < Terms)
+		carryBits++;
+	if (top + carryBits <= 128)
+		return reduced<WORDS + 2>();
+	return reduced<WORDS + 3>();
+}
+
+/*
+ * The sum over N words reduced mod p192, N has to hold the whole sum
+ */
+template <unsigned int Bits, int Terms>
+template <int N>
+constexpr BigInteger<Bits> BigIntegerSum<Bits, Terms>::reduced() const
+{
+	bigIntType t[N] = {};
+	words(t, N);
+	bigIntType r[3] = {0,0,0};
+	bigIntegerReduceWords192(r, t, N, bigIntegerReduce192c);
+	BigInteger<Bits> result;
+	bigIntegerStoreWords192(result.value, WORDS, r);
+	return result;
+}
+
+/*
+ * modp192() of a sum with shifts above 128 bits: x mod p of such a
+ * term is multiplied by 2^128 mod p with one kernel call per 128 bits
+ * of the shift, until the rest of the shift is at most 128 bits, then
+ * the reduced value takes part in the sum. Kept apart so the common
+ * case keeps its operands in registers.
+ */
+template <unsigned int Bits, int Terms>
+constexpr BigInteger<Bits> BigIntegerSum<Bits, Terms>::modp192Folded() const
+{
+	BigIntegerSum sum(*this);
+	BigInteger<Bits> folded[Terms];
+	for (int k=0; k<Terms; k++) {
+		if (shift[k] <= 128)
+			continue;
+		bigIntType r[3] = {0,0,0};
+		bigIntegerReduceWords192(r, operand[k]->value, WORDS, bigIntegerReduce192c);
+		unsigned int s = shift[k];
+		while (s > 128) {
+			const bigIntType t[6] = {0, 0, r[0], r[1], r[2], 0};	// r * 2^128
+			bigIntegerReduce192c(r, t);
+			s -= 128;
+		}
+		bigIntegerStoreWords192(folded[k].value, WORDS, r);
+		sum.operand[k] = &folded[k];
+		sum.shift[k] = s;
+	}
+	return sum.modp192();
+}
+
+//---------------------------------------------------------------
+/*
+ * Operators building the sums. A BigInteger operand becomes a sum
+ * of one term with shift 0.
+ */
+template <unsigned int Bits>
+constexpr BigIntegerSum<Bits, 2> operator + (const BigInteger<Bits> &a, const BigInteger<Bits> &b)
+{
+	return BigIntegerSum<Bits, 2>(BigIntegerSum<Bits, 1>(a, 0), BigIntegerSum<Bits, 1>(b, 0));
+}
+
+template <unsigned int Bits, int Terms>
+constexpr BigIntegerSum<Bits, Terms + 1> operator + (const BigIntegerSum<Bits, Terms> &a, const BigInteger<Bits> &b)
+{
+	return BigIntegerSum<Bits, Terms + 1>(a, BigIntegerSum<Bits, 1>(b, 0));
+}
+
+template <unsigned int Bits, int Terms>
+constexpr BigIntegerSum<Bits, Terms + 1> operator + (const BigInteger<Bits> &a, const BigIntegerSum<Bits, Terms> &b)
+{
+	return BigIntegerSum<Bits, Terms + 1>(BigIntegerSum<Bits, 1>(a, 0), b);
+}
+
+template <unsigned int Bits, int Left, int Right>
+constexpr BigIntegerSum<Bits, Left + Right> operator + (const BigIntegerSum<Bits, Left> &a, const BigIntegerSum<Bits, Right> &b)
+{
+	return BigIntegerSum<Bits, Left + Right>(a, b);
+}
+
+template <unsigned int Bits>
+constexpr BigIntegerSum<Bits, 1> operator << (const BigInteger<Bits> &a, unsigned int val)
+{
+	return BigIntegerSum<Bits, 1>(a, val);
+}
+
+template <unsigned int Bits, int Terms>
+constexpr BigIntegerSum<Bits, Terms> operator << (const BigIntegerSum<Bits, Terms> &a, unsigned int val)
+{
+	return a.shiftedLeft(val);
+}
+
+template <unsigned int Bits, int Terms>
+constexpr BigInteger<Bits> operator % (const BigIntegerSum<Bits, Terms> &a, bigIntegerP192Tag)
+{
+	return a.modp192();
+}
+
+template <unsigned int Bits>
+constexpr BigInteger<Bits> operator % (const BigInteger<Bits> &a, bigIntegerP192Tag)
+{
+	return BigIntegerSum<Bits, 1>(a, 0).modp192();
+}
+
+/*
+ * Output of a sum: it is evaluated, see operator << of BigInteger
+ */
+template <unsigned int Bits, int Terms>
+ostream& operator << (ostream& outstr, const BigIntegerSum<Bits, Terms> &sum)
+{
+	return outstr << BigInteger<Bits>(sum);
+}
+
+#endif	// __BIG_INTEGER_EXPR_H_
@@ -0,0 +1,46 @@
+#ifndef __BIG_INTEGER_MONTGOMERY_H_
+#define __BIG_INTEGER_MONTGOMERY_H_
+
+#include "BigInteger.h"
+
+// Largest window of the sliding-window exponentiation, 2^(w-1) table entries
+#define BIG_INTEGER_MONTGOMERY_MAX_WINDOW 6
+
+//---------------------------------------------------------------
+/*
+ * Montgomery arithmetic for an odd modulus m of no special form
+ * With R = 2^(64k), k being the word count of m, the Montgomery form
+ * of x is x * R mod m. The Montgomery product a * b / R mod m needs
+ * no division: per word of b a multiple of m is added that clears
+ * the lowest word, which is then shifted out. mulCios() interleaves
+ * the two passes per word of b (CIOS), mulFios() the two products
+ * per word of a (FIOS), mul() is the faster one.
+ * modexp() works on normal values, it converts in and out itself.
+ * The widths 192, 256, 384, 521, 1024 and 2048 are instantiated in
+ * BigIntegerMontgomery.cpp. The operations are not constant-time.
+ */
+template <unsigned int Bits = BIG_INTEGER_DEFAULT_BITS>
+class BigIntegerMontgomery
+{
+public:
+	// Number of 64-bit words of the values
+	static const int WORDS = BigInteger<Bits>::WORDS;
+private:
+	int words;									// words of the modulus in use, k
+	bigIntType modulus[WORDS];
+	bigIntType n0;								// -m^-1 mod 2^64
+	BigInteger<Bits> r2;						// R^2 mod m
+	BigInteger<Bits> one;						// R mod m, 1 in Montgomery form
+public:
+	BigIntegerMontgomery(const BigInteger<Bits> &m);	// constructor, m has to be odd
+	bool valid() const { return words > 0; }	// odd modulus above 1?
+	BigInteger<Bits>& toMontgomery(BigInteger<Bits> &x) const;	// x * R mod m
+	BigInteger<Bits>& fromMontgomery(BigInteger<Bits> &x) const;	// x / R mod m
+	BigInteger<Bits>& mul(BigInteger<Bits> &a, const BigInteger<Bits> &b) const;	// a * b / R mod m, fastest variant
+	BigInteger<Bits>& mulCios(BigInteger<Bits> &a, const BigInteger<Bits> &b) const;	// a * b / R mod m
+	BigInteger<Bits>& mulFios(BigInteger<Bits> &a, const BigInteger<Bits> &b) const;	// a * b / R mod m
+	BigInteger<Bits>& modexp(BigInteger<Bits> &x, const BigInteger<Bits> &e) const;	// x^e mod m
+	static int windowBits(int exponentBits);	// window of modexp() for an exponent size
+};
+
+#endif	// __BIG_INTEGER_MONTGOMERY_H_
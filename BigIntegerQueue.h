@@ -0,0 +1,155 @@
+#ifndef __BIG_INTEGER_QUEUE_H_
+#define __BIG_INTEGER_QUEUE_H_
+
+#include <stddef.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+// Rounds a waiting thread spins before it yields, and yields before it sleeps
+#define BIG_INTEGER_QUEUE_SPINS 64
+#define BIG_INTEGER_QUEUE_YIELDS 1024
+
+/*
+ * Backs off a thread waiting on a full or empty queue: spinning
+ * first, then giving up the time slice, then sleeping, so a stage
+ * waiting on a slow pipe does not keep a core busy
+ */
+inline void bigIntegerQueueWait(unsigned int &round)
+{
+	if (round < BIG_INTEGER_QUEUE_SPINS) {
+#if defined(__x86_64__)
+		__builtin_ia32_pause();
+#endif
+	} else if (round < BIG_INTEGER_QUEUE_SPINS + BIG_INTEGER_QUEUE_YIELDS) {
+		std::this_thread::yield();
+	} else {
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+		return;
+	}
+	round++;
+}
+
+//---------------------------------------------------------------
+/*
+ * Bounded queue for any number of producer and consumer threads
+ * The elements are kept in a ring of cells, the capacity is rounded
+ * up to a power of two. Every cell carries a sequence number which
+ * tells whether it is free for the push of position pos (sequence ==
+ * pos) or holds the element of position pos (sequence == pos + 1).
+ * Producers and consumers claim a position with a compare-and-swap on
+ * head or tail and only touch their own cell afterwards, so no lock
+ * is taken and a push is never blocked by a slow pop of another cell.
+ * The elements of one producer are popped in the order it pushed
+ * them. T has to be default constructible and copyable, the queue
+ * is meant for pointers.
+ */
+template <class T>
+class BigIntegerQueue
+{
+private:
+	struct cell {
+		std::atomic<size_t> sequence;
+		T data;
+	};
+	cell *cells;
+	size_t mask;							// capacity - 1
+	alignas(64) std::atomic<size_t> head;	// next position to push
+	alignas(64) std::atomic<size_t> tail;	// next position to pop
+	BigIntegerQueue(const BigIntegerQueue &);	// no copies
+	BigIntegerQueue& operator = (const BigIntegerQueue &);
+public:
+	explicit BigIntegerQueue(size_t capacity);	// constructor, empty
+	~BigIntegerQueue(void) { delete[] cells; }
+	size_t capacity() const { return mask + 1; }
+	bool tryPush(const T &x);				// false if full
+	bool tryPop(T &x);						// false if empty
+	void push(const T &x);					// waits while full
+	T pop();								// waits while empty
+};
+
+/*
+ * Constructor: the capacity is rounded up to a power of two, every
+ * cell is free for the first round of positions
+ */
+template <class T>
+BigIntegerQueue<T>::BigIntegerQueue(size_t capacity) : head(0), tail(0)
+{
+	size_t size = 2;
+	while (size < capacity)
+		size <<= 1;
+	cells = new cell[size];
+	mask = size - 1;
+	for (size_t i=0; i<size; i++)
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+/*
+ * Appends x unless the queue is full
+ */
+template <class T>
+bool BigIntegerQueue<T>::tryPush(const T &x)
+{
+	size_t pos = head.load(std::memory_order_relaxed);
+	for (;;) {
+		cell &c = cells[pos & mask];
+		const size_t seq = c.sequence.load(std::memory_order_acquire);
+		const ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)pos;
+		if (diff == 0) {
+			if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				c.data = x;
+				c.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			return false;					// the cell still holds the element of the last round
+		} else {
+			pos = head.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+/*
+ * Removes the oldest element into x unless the queue is empty
+ */
+template <class T>
+bool BigIntegerQueue<T>::tryPop(T &x)
+{
+	size_t pos = tail.load(std::memory_order_relaxed);
+	for (;;) {
+		cell &c = cells[pos & mask];
+		const size_t seq = c.sequence.load(std::memory_order_acquire);
+		const ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)(pos + 1);
+		if (diff == 0) {
+			if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				x = c.data;
+				c.sequence.store(pos + mask + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			return false;					// nothing pushed at pos yet
+		} else {
+			pos = tail.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <class T>
+void BigIntegerQueue<T>::push(const T &x)
+{
+	unsigned int round = 0;
+	while (!tryPush(x))
+		bigIntegerQueueWait(round);
+}
+
+template <class T>
+T BigIntegerQueue<T>::pop()
+{
+	T x;
+	unsigned int round = 0;
+	while (!tryPop(x))
+		bigIntegerQueueWait(round);
+	return x;
+}
+
+#endif	// __BIG_INTEGER_QUEUE_H_
@@ -0,0 +1,377 @@
+#include "BigIntegerReducer.h"
+
+// Number of 32-bit limbs of the largest modulus
+#define REDUCER_MAX_LIMBS (2 * BIG_INTEGER_REDUCER_MAX_WORDS)
+
+//---------------------------------------------------------------
+/*
+ * Word helpers of the reduction context
+ * The values are little-endian word arrays of explicit length.
+ */
+static inline bigIntType mulWord(bigIntType a, bigIntType b, bigIntType &hi)
+{
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 p = (unsigned __int128)a * b;
+	hi = (bigIntType)(p >> 64);
+	return (bigIntType)p;
+#else
+	bigIntType a0 = a & 0xffffffff, a1 = a >> 32, b0 = b & 0xffffffff, b1 = b >> 32;
+	bigIntType p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+	bigIntType mid = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+	hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+	return (mid << 32) | (p00 & 0xffffffff);
+#endif
+}
+
+/*
+ * r = lower nr words of a * b, schoolbook
+ */
+static void mulWords(bigIntType r[], int nr, const bigIntType a[], int na, const bigIntType b[], int nb)
+{
+	for (int i=0; i<nr; i++)
+		r[i] = 0;
+	for (int i=0; i<na && i<nr; i++) {
+		bigIntType carry = 0;
+		int j;
+		for (j=0; j<nb && i+j<nr; j++) {
+			bigIntType hi, lo = mulWord(a[i], b[j], hi);
+			lo += carry;
+			hi += lo < carry;
+			r[i+j] += lo;
+			hi += r[i+j] < lo;
+			carry = hi;
+		}
+		if (i+j < nr)
+			r[i+j] = carry;
+	}
+}
+
+/*
+ * r -= b, both n words
+ */
+static void subWords(bigIntType r[], const bigIntType b[], int n)
+{
+	bigIntType borrow = 0;
+	for (int i=0; i<n; i++) {
+		bigIntType d = r[i] - b[i];
+		bigIntType borrow_next = r[i] < b[i];
+		borrow_next |= d < borrow;
+		r[i] = d - borrow;
+		borrow = borrow_next;
+	}
+}
+
+/*
+ * a >= b, both n words
+ */
+template <typename Word>
+static bool greaterEqual(const Word a[], const Word b[], int n)
+{
+	for (int i=n-1; i>=0; i--)
+		if (a[i] != b[i])
+			return a[i] > b[i];
+	return true;
+}
+
+/*
+ * 32-bit limb i of a word array
+ */
+static inline uint32_t limb(const bigIntType x[], int i)
+{
+	return (uint32_t)(x[i / 2] >> (32 * (i & 1)));
+}
+
+//---------------------------------------------------------------
+/*
+ * Constructor
+ * Selects and prepares the reduction method for the modulus m.
+ * A modulus below 2 or wider than BIG_INTEGER_REDUCER_MAX_WORDS
+ * words gets BIG_INTEGER_REDUCTION_NONE, reduce() gives 0 then.
+ * @param m the modulus
+ */
+template <unsigned int Bits>
+BigIntegerReducer::BigIntegerReducer(const BigInteger<Bits> &m)
+{
+	init(m.value, BigInteger<Bits>::WORDS);
+}
+
+void BigIntegerReducer::init(const bigIntType m[], int n)
+{
+	while (n > 0 && m[n-1] == 0)
+		n--;
+	method = BIG_INTEGER_REDUCTION_NONE;
+	bits = words = limbs = 0;
+	if (n == 0 || n > BIG_INTEGER_REDUCER_MAX_WORDS || (n == 1 && m[0] < 2))
+		return;
+
+	words = n;
+	bits = 64 * (n-1);
+	for (bigIntType top = m[n-1]; top; top >>= 1)
+		bits++;
+	for (int i=0; i<words; i++)
+		modulus[i] = m[i];
+	method = buildSolinas() ? BIG_INTEGER_REDUCTION_SOLINAS : BIG_INTEGER_REDUCTION_BARRETT;
+	if (method == BIG_INTEGER_REDUCTION_BARRETT)
+		buildBarrett();
+}
+
+/*
+ * Generates the Solinas fold schedule.
+ * With n = 32 * N bits the modulus is p = 2^n - f. f = 2^n - p is
+ * recoded into signed 32-bit digits d_i of -1, 0 and 1, which fails
+ * for moduli of no special form. 2^n = f mod p then turns the upper
+ * limbs into lower ones: limb N+j stands for 2^(32(N+j)), which is
+ * rewritten as sum d_i 2^(32(i+j)) until every index is below N.
+ * The resulting coefficients of the N upper limbs for the N lower
+ * ones are the schedule, only the non-zero ones are kept.
+ * @return false if the modulus is not a generalized Mersenne number
+ */
+bool BigIntegerReducer::buildSolinas()
+{
+	if (bits % 32 != 0)
+		return false;
+	const int N = bits / 32;
+
+	// f = 2^n - p in 32-bit limbs, then signed digits
+	bigIntType borrow = 0;
+	int carry = 0;
+	for (int i=0; i<N; i++) {
+		bigIntType f = (((bigIntType)0 - limb(modulus, i) - borrow) & 0xffffffff) + carry;
+		borrow |= limb(modulus, i) != 0;
+		if (f == 0 || f == 0x100000000ULL) {
+			digits[i] = 0;
+			carry = f != 0;
+		} else if (f == 1) {
+			digits[i] = 1;
+			carry = 0;
+		} else if (f == 0xffffffff) {
+			digits[i] = -1;
+			carry = 1;
+		} else
+			return false;
+	}
+	if (carry)
+		return false;
+
+	// rewrite limb N+j, j = 0 ... N-1, in terms of the limbs below N
+	schedule.clear();
+	for (int j=0; j<N; j++) {
+		int coef[2 * REDUCER_MAX_LIMBS] = {0};
+		coef[N+j] = 1;
+		for (int k=N+j; k>=N; k--) {
+			if (coef[k] == 0)
+				continue;
+			for (int i=0; i<N; i++)
+				coef[k-N+i] += coef[k] * digits[i];
+			coef[k] = 0;
+		}
+		for (int i=0; i<N; i++) {
+			if (coef[i] < -127 || coef[i] > 127)
+				return false;
+			if (coef[i] != 0) {
+				foldTerm term = {(unsigned char)i, (unsigned char)j, (signed char)coef[i]};
+				schedule.push_back(term);
+			}
+		}
+	}
+	limbs = N;
+	for (int i=0; i<N; i++)
+		modulus32[i] = limb(modulus, i);
+	return true;
+}
+
+/*
+ * Computes the Barrett constant mu = floor(2^(128k) / m) for the
+ * k-word modulus by binary long division, it has up to k+2 words.
+ */
+void BigIntegerReducer::buildBarrett()
+{
+	const int k = words;
+	bigIntType rem[BIG_INTEGER_REDUCER_MAX_WORDS + 1] = {0};
+	bigIntType m[BIG_INTEGER_REDUCER_MAX_WORDS + 1] = {0};
+	for (int i=0; i<k; i++)
+		m[i] = modulus[i];
+	for (int i=0; i<k+2; i++)
+		mu[i] = 0;
+	for (int bit=128*k; bit>=0; bit--) {
+		for (int i=k; i>0; i--)
+			rem[i] = (rem[i] << 1) | (rem[i-1] >> 63);
+		rem[0] = (rem[0] << 1) | (bit == 128*k);
+		if (greaterEqual(rem, m, k+1)) {
+			subWords(rem, m, k+1);
+			mu[bit / 64] |= (bigIntType)1 << (bit % 64);
+		}
+	}
+}
+
+//---------------------------------------------------------------
+/*
+ * Solinas reduction of a 2N-limb value t < 2^(2n) to r < p
+ * The schedule adds the upper limbs with their coefficients to the
+ * lower ones in signed 64-bit accumulators, followed by one carry
+ * pass. The carry out of limb N is worth carry * 2^n = carry * f
+ * and is folded back with the digits of f until it vanishes. At
+ * most a few subtractions of p remain.
+ */
+void BigIntegerReducer::reduceSolinas(uint32_t r[], const uint32_t t[]) const
+{
+	const int N = limbs;
+	int64_t acc[REDUCER_MAX_LIMBS];
+	for (int i=0; i<N; i++)
+		acc[i] = t[i];
+	for (size_t i=0; i<schedule.size(); i++)
+		acc[schedule[i].dst] += schedule[i].coef * (int64_t)t[N + schedule[i].src];
+
+	int64_t carry = 0;
+	for (int i=0; i<N; i++) {
+		carry += acc[i];
+		r[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+	while (carry != 0) {
+		int64_t fold = carry;
+		carry = 0;
+		for (int i=0; i<N; i++) {
+			carry += (int64_t)r[i] + fold * digits[i];
+			r[i] = (uint32_t)carry;
+			carry >>= 32;
+		}
+	}
+
+	while (greaterEqual(r, modulus32, N)) {
+		int64_t borrow = 0;
+		for (int i=0; i<N; i++) {
+			borrow += (int64_t)r[i] - modulus32[i];
+			r[i] = (uint32_t)borrow;
+			borrow >>= 32;
+		}
+	}
+}
+
+/*
+ * Barrett reduction of a 2k-word value x < 2^(128k) to r < m
+ * q = floor(floor(x / b^(k-1)) * mu / b^(k+1)) is at most two
+ * below floor(x / m), so x - q*m, computed mod b^(k+1), needs at
+ * most two subtractions of m. b is 2^64.
+ */
+void BigIntegerReducer::reduceBarrett(bigIntType r[], const bigIntType x[]) const
+{
+	const int k = words;
+	bigIntType q2[2 * BIG_INTEGER_REDUCER_MAX_WORDS + 3];
+	bigIntType q3m[BIG_INTEGER_REDUCER_MAX_WORDS + 1];
+	bigIntType rem[BIG_INTEGER_REDUCER_MAX_WORDS + 1];
+	bigIntType m[BIG_INTEGER_REDUCER_MAX_WORDS + 1];
+
+	mulWords(q2, 2*k+3, x + k-1, k+1, mu, k+2);
+	mulWords(q3m, k+1, q2 + k+1, k+2, modulus, k);
+	for (int i=0; i<=k; i++) {
+		rem[i] = x[i];
+		m[i] = (i < k) ? modulus[i] : 0;
+	}
+	subWords(rem, q3m, k+1);
+	while (greaterEqual(rem, m, k+1))
+		subWords(rem, m, k+1);
+	for (int i=0; i<k; i++)
+		r[i] = rem[i];
+}
+
+/*
+ * r = x mod m for an n-word value x, r has words words
+ * Both methods reduce at most twice the modulus width at once. The
+ * value is processed from the top: the upper 2k words (2N limbs)
+ * are reduced first, then the remainder is shifted up by the next
+ * chunk of at most k words (N limbs) of x and reduced again.
+ */
+void BigIntegerReducer::reduceWords(bigIntType r[], const bigIntType x[], int n) const
+{
+	if (method == BIG_INTEGER_REDUCTION_SOLINAS) {
+		const int N = limbs;
+		uint32_t t[2 * REDUCER_MAX_LIMBS], rl[REDUCER_MAX_LIMBS];
+		int pos = 2 * n, s = (pos < 2*N) ? pos : 2*N;
+		pos -= s;
+		for (int i=0; i<2*N; i++)
+			t[i] = (i < s) ? limb(x, pos + i) : 0;
+		reduceSolinas(rl, t);
+		while (pos > 0) {
+			s = (pos < N) ? pos : N;
+			pos -= s;
+			for (int i=0; i<2*N; i++)
+				t[i] = (i < s) ? limb(x, pos + i) : (i < s+N) ? rl[i-s] : 0;
+			reduceSolinas(rl, t);
+		}
+		for (int i=0; i<words; i++)
+			r[i] = rl[2*i] | ((2*i+1 < N) ? (bigIntType)rl[2*i+1] << 32 : 0);
+	} else if (method == BIG_INTEGER_REDUCTION_BARRETT) {
+		const int k = words;
+		bigIntType t[2 * BIG_INTEGER_REDUCER_MAX_WORDS];
+		int pos = n, s = (pos < 2*k) ? pos : 2*k;
+		pos -= s;
+		for (int i=0; i<2*k; i++)
+			t[i] = (i < s) ? x[pos + i] : 0;
+		reduceBarrett(r, t);
+		while (pos > 0) {
+			s = (pos < k) ? pos : k;
+			pos -= s;
+			for (int i=0; i<2*k; i++)
+				t[i] = (i < s) ? x[pos + i] : (i < s+k) ? r[i-s] : 0;
+			reduceBarrett(r, t);
+		}
+	}
+}
+
+/*
+ * Reduces x modulo the modulus of the context
+ * @param x any value, it is replaced by x mod m
+ */
+template <unsigned int Bits>
+BigInteger<Bits>& BigIntegerReducer::reduce(BigInteger<Bits> &x) const
+{
+	bigIntType r[BIG_INTEGER_REDUCER_MAX_WORDS];
+	reduceWords(r, x.value, BigInteger<Bits>::WORDS);
+	for (int i=0; i<BigInteger<Bits>::WORDS; i++)
+		x.value[i] = (i < words) ? r[i] : 0;
+	return x;
+}
+
+//---------------------------------------------------------------
+/*
+ * Contexts of the NIST primes, built on first use from moduli that
+ * are constants of the binary
+ *	P-224 = 2^224 - 2^96 + 1
+ *	P-256 = 2^256 - 2^224 + 2^192 + 2^96 - 1
+ *	P-384 = 2^384 - 2^128 - 2^96 + 2^32 - 1
+ */
+static constexpr BigInteger<256> P224(0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF000000000000000000000001_big);
+static constexpr BigInteger<256> P256(0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF_big);
+static constexpr BigInteger<384> P384(0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFE'FFFFFFFF0000000000000000FFFFFFFF_big);
+
+const BigIntegerReducer &BigIntegerReducer::p224()
+{
+	static const BigIntegerReducer context(P224);
+	return context;
+}
+
+const BigIntegerReducer &BigIntegerReducer::p256()
+{
+	static const BigIntegerReducer context(P256);
+	return context;
+}
+
+const BigIntegerReducer &BigIntegerReducer::p384()
+{
+	static const BigIntegerReducer context(P384);
+	return context;
+}
+
+//---------------------------------------------------------------
+/*
+ * Widths instantiated by this translation unit, as in BigInteger.cpp
+ */
+#define BIG_INTEGER_REDUCER_INSTANTIATE(bits) \
+	template BigIntegerReducer::BigIntegerReducer(const BigInteger<bits> &); \
+	template BigInteger<bits>& BigIntegerReducer::reduce(BigInteger<bits> &) const;
+
+BIG_INTEGER_REDUCER_INSTANTIATE(192)
+BIG_INTEGER_REDUCER_INSTANTIATE(256)
+BIG_INTEGER_REDUCER_INSTANTIATE(384)
+BIG_INTEGER_REDUCER_INSTANTIATE(521)
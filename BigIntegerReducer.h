@@ -0,0 +1,67 @@
+#ifndef __BIG_INTEGER_REDUCER_H_
+#define __BIG_INTEGER_REDUCER_H_
+
+#include <vector>
+#include "BigInteger.h"
+
+// Largest modulus in 64-bit words, enough for P-521
+#define BIG_INTEGER_REDUCER_MAX_WORDS 9
+
+// Reduction method chosen for a modulus
+enum bigIntegerReduction {
+	BIG_INTEGER_REDUCTION_SOLINAS,	// generalized Mersenne prime, fold schedule
+	BIG_INTEGER_REDUCTION_BARRETT,	// any other modulus, Barrett constant
+	BIG_INTEGER_REDUCTION_NONE		// modulus below 2 or too wide
+};
+
+//---------------------------------------------------------------
+/*
+ * Reduction context for a fixed modulus
+ * The modulus is analysed once by the constructor. A generalized
+ * Mersenne number p = 2^n - f, where n is a multiple of 32 and f
+ * has signed 32-bit digits of -1, 0 and 1 (P-192, P-224, P-256,
+ * P-384), gets a generated Solinas fold schedule: a list of
+ * (source limb, destination limb, coefficient) terms that replaces
+ * the hand-written word-index table of modp192c(). Every other
+ * modulus gets the Barrett constant floor(2^(128k) / m), k being
+ * its word count.
+ * reduce() takes a value of any width and works with whole chunks
+ * of the modulus width from the top, so no division is needed.
+ */
+class BigIntegerReducer
+{
+private:
+	// One term of the Solinas fold: limb dst += coef * limb src
+	struct foldTerm {
+		unsigned char dst, src;
+		signed char coef;
+	};
+	bigIntegerReduction method;
+	int bits;									// bit length of the modulus
+	int words;									// 64-bit words of the modulus
+	bigIntType modulus[BIG_INTEGER_REDUCER_MAX_WORDS];
+	bigIntType mu[BIG_INTEGER_REDUCER_MAX_WORDS + 2];	// Barrett constant
+	int limbs;									// Solinas: 32-bit limbs of the modulus
+	uint32_t modulus32[2 * BIG_INTEGER_REDUCER_MAX_WORDS];	// Solinas: the modulus in limbs
+	signed char digits[2 * BIG_INTEGER_REDUCER_MAX_WORDS];	// Solinas: signed digits of f
+	std::vector<foldTerm> schedule;				// Solinas: fold of the upper limbs
+
+	void init(const bigIntType m[], int n);
+	bool buildSolinas();
+	void buildBarrett();
+	void reduceSolinas(uint32_t r[], const uint32_t t[]) const;
+	void reduceBarrett(bigIntType r[], const bigIntType x[]) const;
+	void reduceWords(bigIntType r[], const bigIntType x[], int n) const;
+public:
+	template <unsigned int Bits>
+	BigIntegerReducer(const BigInteger<Bits> &m);	// constructor, analyses the modulus
+	bigIntegerReduction reduction() const { return method; }	// method in use
+	int modulusBits() const { return bits; }	// bit length of the modulus
+	template <unsigned int Bits>
+	BigInteger<Bits>& reduce(BigInteger<Bits> &x) const;	// x mod m in place
+	static const BigIntegerReducer &p224();		// context of the NIST prime P-224
+	static const BigIntegerReducer &p256();		// context of the NIST prime P-256
+	static const BigIntegerReducer &p384();		// context of the NIST prime P-384
+};
+
+#endif	// __BIG_INTEGER_REDUCER_H_
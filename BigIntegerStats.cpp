@@ -0,0 +1,287 @@
+#include "BigIntegerStats.h"
+#include "BigInteger.h"
+#include <string.h>
+#if defined(BIG_INTEGER_STATS)
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define BIG_INTEGER_USDT
+#endif
+#endif
+#endif
+
+static const char *const OpNames[] = {
+	"add", "modp192", "mul192", "sqr192", "mulmod192", "sqrmod192", "addmod192", "submod192",
+	"invmod192", "invmod192gcd", "invmod192Batch", "sqrtmod192", "legendre192",
+	"fromHex", "toHex", "fromDecimal", "toDecimal"
+};
+
+static const char *const EventNames[] = {
+	"reduce192 kernel calls", "carry into the first fold", "second fold", "subtraction of p"
+};
+
+const char *bigIntegerOpName(bigIntegerOp op)
+{
+	return OpNames[op];
+}
+
+const char *bigIntegerEventName(bigIntegerEvent event)
+{
+	return EventNames[event];
+}
+
+/*
+ * Trace point of the operations: perf attaches a uprobe here, the
+ * empty asm keeps the call from being optimized away
+ */
+extern "C" __attribute__((noinline)) void bigIntegerTraceProbe(int op, uint64_t cycles)
+{
+	__asm__ volatile ("" : : "r"(op), "r"(cycles) : "memory");
+}
+
+#if defined(BIG_INTEGER_STATS)
+//---------------------------------------------------------------
+/*
+ * Counters of one thread. Only the owning thread writes them, with a
+ * relaxed load and store instead of a locked add, the snapshot reads
+ * them from any thread.
+ */
+struct statsCounters {
+	std::atomic<uint64_t> calls[BIG_INTEGER_OP_COUNT];
+	std::atomic<uint64_t> cycles[BIG_INTEGER_OP_COUNT];
+	std::atomic<uint64_t> histogram[BIG_INTEGER_OP_COUNT][BIG_INTEGER_STATS_BUCKETS];
+	std::atomic<uint64_t> events[BIG_INTEGER_EVENT_COUNT];
+	statsCounters(void) { clear(); }
+	void clear();
+	void addTo(bigIntegerOpStats ops[], uint64_t events[]) const;
+};
+
+static inline void bump(std::atomic<uint64_t> &counter, uint64_t n)
+{
+	counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+void statsCounters::clear()
+{
+	for (int i=0; i<BIG_INTEGER_OP_COUNT; i++) {
+		calls[i].store(0, std::memory_order_relaxed);
+		cycles[i].store(0, std::memory_order_relaxed);
+		for (int b=0; b<BIG_INTEGER_STATS_BUCKETS; b++)
+			histogram[i][b].store(0, std::memory_order_relaxed);
+	}
+	for (int e=0; e<BIG_INTEGER_EVENT_COUNT; e++)
+		events[e].store(0, std::memory_order_relaxed);
+}
+
+void statsCounters::addTo(bigIntegerOpStats ops[], uint64_t sums[]) const
+{
+	for (int i=0; i<BIG_INTEGER_OP_COUNT; i++) {
+		ops[i].calls += calls[i].load(std::memory_order_relaxed);
+		ops[i].cycles += cycles[i].load(std::memory_order_relaxed);
+		for (int b=0; b<BIG_INTEGER_STATS_BUCKETS; b++)
+			ops[i].histogram[b] += histogram[i][b].load(std::memory_order_relaxed);
+	}
+	for (int e=0; e<BIG_INTEGER_EVENT_COUNT; e++)
+		sums[e] += events[e].load(std::memory_order_relaxed);
+}
+
+/*
+ * All counters: the ones of the running threads and the sum of the
+ * threads that have ended
+ */
+struct statsRegistry {
+	std::mutex lock;
+	std::vector<statsCounters *> threads;
+	bigIntegerOpStats retiredOps[BIG_INTEGER_OP_COUNT];
+	uint64_t retiredEvents[BIG_INTEGER_EVENT_COUNT];
+	statsRegistry(void)
+	{
+		memset(retiredOps, 0, sizeof(retiredOps));
+		memset(retiredEvents, 0, sizeof(retiredEvents));
+	}
+};
+
+static statsRegistry &registry()
+{
+	static statsRegistry r;
+	return r;
+}
+
+/*
+ * Counters of the calling thread, registered on first use and added
+ * to the retired sums when the thread ends
+ */
+struct statsThread {
+	statsCounters counters;
+	statsThread(void)
+	{
+		statsRegistry &r = registry();
+		std::lock_guard<std::mutex> guard(r.lock);
+		r.threads.push_back(&counters);
+	}
+	~statsThread(void)
+	{
+		statsRegistry &r = registry();
+		std::lock_guard<std::mutex> guard(r.lock);
+		counters.addTo(r.retiredOps, r.retiredEvents);
+		r.threads.erase(std::find(r.threads.begin(), r.threads.end(), &counters));
+	}
+};
+
+static statsCounters &local()
+{
+	static thread_local statsThread t;
+	return t.counters;
+}
+
+void bigIntegerStatsRecord(bigIntegerOp op, uint64_t cycles)
+{
+	statsCounters &c = local();
+	int bucket = (cycles == 0) ? 0 : 63 - __builtin_clzll(cycles);
+	if (bucket >= BIG_INTEGER_STATS_BUCKETS)
+		bucket = BIG_INTEGER_STATS_BUCKETS - 1;
+	bump(c.calls[op], 1);
+	bump(c.cycles[op], cycles);
+	bump(c.histogram[op][bucket], 1);
+	bigIntegerTraceProbe(op, cycles);
+#if defined(BIG_INTEGER_USDT)
+	DTRACE_PROBE2(biginteger, op, (int)op, cycles);
+#endif
+}
+
+/*
+ * Counts the rare paths the reduction of t takes. The sum is
+ * recomputed like in bigIntegerReduce192c(), the kernels themselves
+ * stay untouched and every variant gives the same counts.
+ */
+void bigIntegerStatsReduceEvents(const uint64_t t[6])
+{
+	bigIntType lo = t[0], hi = 0, r0, r1, r2, c;
+	bigIntegerAccumulate(lo, hi, t[3]);
+	bigIntegerAccumulate(lo, hi, t[5]);
+	r0 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, t[1]);
+	bigIntegerAccumulate(lo, hi, t[3]);
+	bigIntegerAccumulate(lo, hi, t[4]);
+	bigIntegerAccumulate(lo, hi, t[5]);
+	r1 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, t[2]);
+	bigIntegerAccumulate(lo, hi, t[4]);
+	bigIntegerAccumulate(lo, hi, t[5]);
+	r2 = lo; c = hi;
+
+	// first fold: + (0,c,c), o is its carry
+	lo = r0; hi = 0;
+	bigIntegerAccumulate(lo, hi, c);
+	r0 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, r1);
+	bigIntegerAccumulate(lo, hi, c);
+	r1 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, r2);
+	r2 = lo;
+	const bigIntType o = hi;
+
+	// second fold, then r >= p?
+	lo = r0; hi = 0;
+	bigIntegerAccumulate(lo, hi, o);
+	r0 = lo; lo = hi; hi = 0;
+	bigIntegerAccumulate(lo, hi, r1);
+	bigIntegerAccumulate(lo, hi, o);
+	r1 = lo;
+	r2 += hi;
+	const bool geP = r2 == ~(bigIntType)0 && (r1 > 0xfffffffffffffffeULL || (r1 == 0xfffffffffffffffeULL && r0 == ~(bigIntType)0));
+
+	statsCounters &counters = local();
+	bump(counters.events[BIG_INTEGER_EVENT_REDUCE], 1);
+	bump(counters.events[BIG_INTEGER_EVENT_FOLD_CARRY], c != 0);
+	bump(counters.events[BIG_INTEGER_EVENT_SECOND_FOLD], o != 0);
+	bump(counters.events[BIG_INTEGER_EVENT_SUBTRACT_P], geP);
+}
+
+bool bigIntegerStatsEnabled()
+{
+	return true;
+}
+
+void bigIntegerStatsSnapshot(bigIntegerOpStats ops[BIG_INTEGER_OP_COUNT], uint64_t events[BIG_INTEGER_EVENT_COUNT])
+{
+	statsRegistry &r = registry();
+	std::lock_guard<std::mutex> guard(r.lock);
+	memcpy(ops, r.retiredOps, sizeof(r.retiredOps));
+	memcpy(events, r.retiredEvents, sizeof(r.retiredEvents));
+	for (size_t i=0; i<r.threads.size(); i++)
+		r.threads[i]->addTo(ops, events);
+}
+
+void bigIntegerStatsReset()
+{
+	statsRegistry &r = registry();
+	std::lock_guard<std::mutex> guard(r.lock);
+	memset(r.retiredOps, 0, sizeof(r.retiredOps));
+	memset(r.retiredEvents, 0, sizeof(r.retiredEvents));
+	for (size_t i=0; i<r.threads.size(); i++)
+		r.threads[i]->clear();
+}
+
+#else
+//---------------------------------------------------------------
+// Compiled out: nothing is counted
+
+bool bigIntegerStatsEnabled()
+{
+	return false;
+}
+
+void bigIntegerStatsSnapshot(bigIntegerOpStats ops[BIG_INTEGER_OP_COUNT], uint64_t events[BIG_INTEGER_EVENT_COUNT])
+{
+	memset(ops, 0, BIG_INTEGER_OP_COUNT * sizeof(bigIntegerOpStats));
+	memset(events, 0, BIG_INTEGER_EVENT_COUNT * sizeof(uint64_t));
+}
+
+void bigIntegerStatsReset()
+{
+}
+#endif
+
+//---------------------------------------------------------------
+/*
+ * Writes one line per operation that was called: calls, mean cycles
+ * and the histogram buckets in use as "2^k:count", then the events of
+ * the reduction with their share of the kernel calls
+ */
+void bigIntegerStatsDump(ostream &out)
+{
+	if (!bigIntegerStatsEnabled()) {
+		out << "BigInteger statistics: compiled out, build with make STATS=1" << std::endl;
+		return;
+	}
+	bigIntegerOpStats ops[BIG_INTEGER_OP_COUNT];
+	uint64_t events[BIG_INTEGER_EVENT_COUNT];
+	bigIntegerStatsSnapshot(ops, events);
+
+	const std::ios_base::fmtflags flags = out.flags();
+	out << std::dec << "BigInteger statistics (cycles are time-stamp counter ticks)" << std::endl;
+	for (int i=0; i<BIG_INTEGER_OP_COUNT; i++) {
+		if (ops[i].calls == 0)
+			continue;
+		out << "  " << OpNames[i] << ": " << ops[i].calls << " calls, "
+		    << ops[i].cycles / ops[i].calls << " cycles mean, histogram";
+		for (int b=0; b<BIG_INTEGER_STATS_BUCKETS; b++)
+			if (ops[i].histogram[b])
+				out << " 2^" << b << ":" << ops[i].histogram[b];
+		out << std::endl;
+	}
+	const uint64_t reductions = events[BIG_INTEGER_EVENT_REDUCE];
+	out << "  " << EventNames[BIG_INTEGER_EVENT_REDUCE] << ": " << reductions << std::endl;
+	for (int e=BIG_INTEGER_EVENT_REDUCE+1; e<BIG_INTEGER_EVENT_COUNT; e++) {
+		out << "  " << EventNames[e] << ": " << events[e];
+		if (reductions)
+			out << " (" << 100.0 * events[e] / reductions << "%)";
+		out << std::endl;
+	}
+	out.flags(flags);
+}
@@ -0,0 +1,119 @@
+#ifndef __BIG_INTEGER_STATS_H_
+#define __BIG_INTEGER_STATS_H_
+
+#include <stdint.h>
+#include <iostream>
+	using std::ostream;
+#if defined(BIG_INTEGER_STATS)
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+//---------------------------------------------------------------
+/*
+ * Optional instrumentation of the BigInteger operations
+ * Compiled out unless BIG_INTEGER_STATS is defined ("make STATS=1"
+ * after "make clean"): then every traced operation counts its calls,
+ * measures its duration with the time-stamp counter (RDTSC, reference
+ * cycles) into a histogram of power-of-two buckets and fires a trace
+ * point. The reduction kernel mod p192 also counts how often the
+ * carry into the first fold, the rare second fold and the final
+ * subtraction of p occur. The counters are kept per
+ * thread and summed up by the snapshot, the counts of threads that
+ * have ended are kept.
+ * Trace points: bigIntegerTraceProbe() is an extern "C" function
+ * that is never inlined, so "perf probe -x <binary>
+ * bigIntegerTraceProbe op cycles" attaches to it. If <sys/sdt.h> is
+ * available a USDT probe biginteger:op (op, cycles) is compiled in
+ * as well, for perf, bpftrace or SystemTap.
+ * Without BIG_INTEGER_STATS the API below still links: the snapshot
+ * is zero and the dump says that the instrumentation is compiled out.
+ */
+
+// Traced operations
+enum bigIntegerOp {
+	BIG_INTEGER_OP_ADD,
+	BIG_INTEGER_OP_MODP192,
+	BIG_INTEGER_OP_MUL192,
+	BIG_INTEGER_OP_SQR192,
+	BIG_INTEGER_OP_MULMOD192,
+	BIG_INTEGER_OP_SQRMOD192,
+	BIG_INTEGER_OP_ADDMOD192,
+	BIG_INTEGER_OP_SUBMOD192,
+	BIG_INTEGER_OP_INVMOD192,
+	BIG_INTEGER_OP_INVMOD192_GCD,
+	BIG_INTEGER_OP_INVMOD192_BATCH,
+	BIG_INTEGER_OP_SQRTMOD192,
+	BIG_INTEGER_OP_LEGENDRE192,
+	BIG_INTEGER_OP_FROM_HEX,
+	BIG_INTEGER_OP_TO_HEX,
+	BIG_INTEGER_OP_FROM_DECIMAL,
+	BIG_INTEGER_OP_TO_DECIMAL,
+	BIG_INTEGER_OP_COUNT
+};
+
+// Events of the reduction kernel mod p192
+enum bigIntegerEvent {
+	BIG_INTEGER_EVENT_REDUCE,		// calls of the 384-bit kernel
+	BIG_INTEGER_EVENT_FOLD_CARRY,	// carry out of bit 192, the first fold adds it
+	BIG_INTEGER_EVENT_SECOND_FOLD,	// the first fold carried again
+	BIG_INTEGER_EVENT_SUBTRACT_P,	// the result was not below p
+	BIG_INTEGER_EVENT_COUNT
+};
+
+// Histogram bucket k counts the durations of 2^k to 2^(k+1) - 1 cycles,
+// the last one everything above
+#define BIG_INTEGER_STATS_BUCKETS 32
+
+struct bigIntegerOpStats {
+	uint64_t calls;
+	uint64_t cycles;				// sum of the durations
+	uint64_t histogram[BIG_INTEGER_STATS_BUCKETS];
+};
+
+bool bigIntegerStatsEnabled();						// compiled with BIG_INTEGER_STATS?
+const char *bigIntegerOpName(bigIntegerOp op);
+const char *bigIntegerEventName(bigIntegerEvent event);
+// Sum of all threads, the counters of a running thread may lag behind by an operation
+void bigIntegerStatsSnapshot(bigIntegerOpStats ops[BIG_INTEGER_OP_COUNT], uint64_t events[BIG_INTEGER_EVENT_COUNT]);
+void bigIntegerStatsReset();						// zero, other threads should be idle
+void bigIntegerStatsDump(ostream &out);				// table of the operations called and the events
+
+extern "C" void bigIntegerTraceProbe(int op, uint64_t cycles);	// trace point, does nothing
+
+#if defined(BIG_INTEGER_STATS)
+void bigIntegerStatsRecord(bigIntegerOp op, uint64_t cycles);
+void bigIntegerStatsReduceEvents(const uint64_t t[6]);	// classifies a reduction input
+
+// Time stamp of the durations: the time-stamp counter on x86, else nanoseconds
+#if defined(__x86_64__)
+inline uint64_t bigIntegerStatsClock() { return __rdtsc(); }
+#else
+inline uint64_t bigIntegerStatsClock()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+/*
+ * Measures the operation of the enclosing block
+ */
+class bigIntegerTraceScope
+{
+private:
+	bigIntegerOp op;
+	uint64_t start;
+public:
+	explicit bigIntegerTraceScope(bigIntegerOp op) : op(op), start(bigIntegerStatsClock()) {}
+	~bigIntegerTraceScope(void) { bigIntegerStatsRecord(op, bigIntegerStatsClock() - start); }
+};
+
+#define BIG_INTEGER_TRACE(op) bigIntegerTraceScope bigIntegerTrace_(op)
+#else
+#define BIG_INTEGER_TRACE(op) ((void)0)
+#endif
+
+#endif	// __BIG_INTEGER_STATS_H_
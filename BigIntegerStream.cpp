@@ -0,0 +1,212 @@
+#include "BigIntegerStream.h"
+#include "BigIntegerQueue.h"
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+//---------------------------------------------------------------
+/*
+ * One block of input lines and the formatted results. The buffers
+ * keep their capacity when the block is recycled.
+ */
+struct streamBlock {
+	std::vector<char> input;		// complete lines in input[0..length)
+	size_t length;
+	std::string output;				// reduced values, one per line
+	size_t values;					// number of values in the block
+	const char *invalid;			// first invalid line, 0 if none
+	size_t sequence;				// position in the input
+	size_t offset;					// byte offset of input[0] in the input
+};
+
+/*
+ * Shared state of one streaming reduction
+ * free:   empty blocks, writer -> reader
+ * filled: blocks read, reader -> workers, a null pointer per worker
+ *         ends the input
+ * done:   reduced blocks, workers -> writer in any order, every
+ *         worker ends with a null pointer
+ */
+struct streamJob {
+	std::vector<streamBlock> pool;
+	BigIntegerQueue<streamBlock *> free, filled, done;
+	std::atomic<bool> failed;		// stops the reader after a write error
+	int readError;					// errno of a failed read, 0 if none
+	streamJob(size_t blocks, size_t capacity)
+		: pool(blocks), free(capacity), filled(capacity), done(capacity), failed(false), readError(0) {}
+};
+
+//---------------------------------------------------------------
+/*
+ * One read() of at most size bytes, repeated if a signal interrupts it
+ * @return the bytes read, 0 at the end of the input, -1 on errors
+ */
+static ssize_t readSome(int fd, char *buf, size_t size)
+{
+	for (;;) {
+		ssize_t n = read(fd, buf, size);
+		if (n >= 0 || errno != EINTR)
+			return n;
+	}
+}
+
+static bool writeFull(int fd, const char *buf, size_t size)
+{
+	while (size > 0) {
+		ssize_t n = write(fd, buf, size);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		buf += n;
+		size -= n;
+	}
+	return true;
+}
+
+/*
+ * Reader stage: fills the free blocks with complete lines. A block is
+ * handed on as soon as a read() brings a newline, so the lines of a
+ * slow producer are reduced while it is still writing, a regular
+ * file still fills a whole block per read(). The part behind the
+ * last newline starts the next block. A line longer than a block
+ * makes the block grow until the line ends.
+ */
+static void reader(streamJob &job, int in, unsigned int workers)
+{
+	std::string carry;
+	size_t sequence = 0, offset = 0;
+	bool eof = false;
+	while (!eof && !job.failed.load(std::memory_order_relaxed)) {
+		streamBlock *block = job.free.pop();
+		if (block->input.size() < BIG_INTEGER_STREAM_BLOCK + carry.size())
+			block->input.resize(BIG_INTEGER_STREAM_BLOCK + carry.size());
+		memcpy(&block->input[0], carry.data(), carry.size());
+		block->length = carry.size();
+		carry.clear();
+
+		const char *eol = 0;
+		while (!eof && !eol) {
+			if (block->length == block->input.size())
+				block->input.resize(2 * block->input.size());
+			const size_t start = block->length;
+			ssize_t got = readSome(in, &block->input[start], block->input.size() - start);
+			if (got < 0) {
+				job.readError = errno;
+				got = 0;
+			}
+			block->length += got;
+			eof = got == 0;
+			eol = (const char *)memrchr(&block->input[start], '\n', got);
+		}
+		if (eof && block->length == 0) {
+			job.free.push(block);
+			break;
+		}
+		if (eol) {
+			const char *end = &block->input[0] + block->length;
+			carry.assign(eol + 1, end);
+			block->length = eol + 1 - &block->input[0];
+		}
+		block->sequence = sequence++;
+		block->offset = offset;
+		offset += block->length;
+		job.filled.push(block);
+	}
+	for (unsigned int w=0; w<workers; w++)
+		job.filled.push(0);
+}
+
+/*
+ * Worker stage: reduces blocks until the reader ends the input
+ */
+static void worker(streamJob &job)
+{
+	streamBlock *block;
+	while ((block = job.filled.pop()) != 0) {
+		const char *begin = block->input.data();
+		block->output.clear();
+		block->values = bigIntegerBulkReduceLines(begin, begin + block->length, block->output, &block->invalid);
+		job.done.push(block);
+	}
+	job.done.push(0);
+}
+
+//---------------------------------------------------------------
+/*
+ * Runs the three stages, see BigIntegerStream.h
+ * The writer holds the blocks finished out of order in pending[],
+ * indexed by their sequence modulo the pool size: at most the whole
+ * pool is in flight, so the slots never collide.
+ */
+bool bigIntegerStreamReduce(int in, int out, unsigned int threads, bigIntegerBulkStats *stats)
+{
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+		if (threads > 1)
+			threads--;					// for the reader and the writer
+	}
+	if (threads == 0)
+		threads = 1;
+
+	const size_t blocks = 2 * threads + 2;
+	streamJob job(blocks, blocks + threads);
+	for (size_t i=0; i<blocks; i++)
+		job.free.push(&job.pool[i]);
+
+	std::thread input(reader, std::ref(job), in, threads);
+	std::vector<std::thread> pool;
+	for (unsigned int w=0; w<threads; w++)
+		pool.push_back(std::thread(worker, std::ref(job)));
+
+	// write the blocks in input order up to the first invalid line
+	std::vector<streamBlock *> pending(blocks, (streamBlock *)0);
+	size_t next = 0, values = 0, invalidOffset = 0;
+	unsigned int finished = 0;
+	int writeError = 0;
+	bool invalid = false;
+	while (finished < threads) {
+		streamBlock *block = job.done.pop();
+		if (!block) {
+			finished++;
+			continue;
+		}
+		pending[block->sequence % blocks] = block;
+		while ((block = pending[next % blocks]) != 0 && block->sequence == next) {
+			pending[next % blocks] = 0;
+			if (!invalid && !writeError) {
+				if (!writeFull(out, block->output.data(), block->output.size()))
+					writeError = errno;
+				values += block->values;
+				if (block->invalid) {
+					invalid = true;
+					invalidOffset = block->offset + (block->invalid - block->input.data());
+				}
+				if (writeError || invalid)
+					job.failed.store(true, std::memory_order_relaxed);
+			}
+			next++;
+			job.free.push(block);
+		}
+	}
+	input.join();
+	for (unsigned int w=0; w<threads; w++)
+		pool[w].join();
+
+	if (stats) {
+		stats->values = values;
+		stats->chunks = next;
+		stats->threads = threads;
+		stats->invalidOffset = invalidOffset;
+	}
+	if (job.readError || writeError || invalid) {
+		errno = invalid ? EINVAL : job.readError ? job.readError : writeError;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,37 @@
+#ifndef __BIG_INTEGER_STREAM_H_
+#define __BIG_INTEGER_STREAM_H_
+
+#include <stddef.h>
+#include "BigIntegerBulk.h"
+
+// Bytes one read() of the reader asks for, the size of a block
+#define BIG_INTEGER_STREAM_BLOCK (1 << 20)
+
+//---------------------------------------------------------------
+/*
+ * Streaming reduction of hexadecimal values mod p192
+ * Same input and output format as bigIntegerBulkReduce(), but the
+ * input is read from a file descriptor while it is reduced, so it
+ * may be a pipe and is never held in memory as a whole. Three stages
+ * run at the same time:
+ *	- a reader thread reads blocks of up to BIG_INTEGER_STREAM_BLOCK
+ *	  bytes and cuts them behind the last complete line, the rest is
+ *	  carried over into the next block. A block is passed on after
+ *	  the first read() that brings a newline, so the lines of a slow
+ *	  pipe are answered without waiting for the block to fill,
+ *	- the worker threads parse, reduce and format a block each,
+ *	- the calling thread writes the blocks back in input order.
+ * The stages pass block pointers through bounded lock-free queues
+ * (BigIntegerQueue). The blocks come from a fixed pool which is
+ * recycled from the writer back to the reader, so the memory stays
+ * bounded and a slow consumer of the output stalls the reader instead
+ * of filling memory.
+ * stats->chunks counts the blocks.
+ */
+// Reduces the values read from in and writes them to out.
+// threads = 0 uses one worker per hardware thread but one.
+// Returns false on I/O errors and at the first invalid line, see
+// bigIntegerBulkReduce(), errno tells the reason.
+bool bigIntegerStreamReduce(int in, int out, unsigned int threads = 0, bigIntegerBulkStats *stats = 0);
+
+#endif	// __BIG_INTEGER_STREAM_H_
@@ -0,0 +1,428 @@
+#include "BigIntegerVar.h"
+#include <string>
+#include <utility>
+
+//---------------------------------------------------------------
+/*
+ * Constructors
+ * The value starts in inlineWords[], an arena block is only taken
+ * when it grows beyond BIG_INTEGER_VAR_INLINE_WORDS words.
+ */
+BigIntegerVar::BigIntegerVar(BigIntegerArena &arena)
+	: limbs(inlineWords), used(0), capacity(BIG_INTEGER_VAR_INLINE_WORDS), arena(&arena)
+{
+}
+
+BigIntegerVar::BigIntegerVar(bigIntType val, BigIntegerArena &arena)
+	: limbs(inlineWords), used(val != 0), capacity(BIG_INTEGER_VAR_INLINE_WORDS), arena(&arena)
+{
+	inlineWords[0] = val;
+}
+
+/*
+ * Constructor: from a hexadecimal string, see fromHex()
+ */
+BigIntegerVar::BigIntegerVar(const char str[], BigIntegerArena &arena)
+	: limbs(inlineWords), used(0), capacity(BIG_INTEGER_VAR_INLINE_WORDS), arena(&arena)
+{
+	fromHex(str);
+}
+
+/*
+ * Copy constructor, the copy uses the arena of the creating thread:
+ * the arena of other may belong to another thread
+ */
+BigIntegerVar::BigIntegerVar(const BigIntegerVar &other)
+	: limbs(inlineWords), used(0), capacity(BIG_INTEGER_VAR_INLINE_WORDS), arena(&BigIntegerArena::local())
+{
+	assign(other.limbs, other.used);
+}
+
+/*
+ * Move constructor: the block of other is taken over, other is zero
+ * afterwards
+ */
+BigIntegerVar::BigIntegerVar(BigIntegerVar &&other)
+	: limbs(inlineWords), used(0), capacity(BIG_INTEGER_VAR_INLINE_WORDS), arena(other.arena)
+{
+	if (other.isInline()) {
+		assign(other.limbs, other.used);
+	} else {
+		limbs = other.limbs;
+		used = other.used;
+		capacity = other.capacity;
+		other.limbs = other.inlineWords;
+		other.capacity = BIG_INTEGER_VAR_INLINE_WORDS;
+	}
+	other.used = 0;
+}
+
+BigIntegerVar& BigIntegerVar::operator = (const BigIntegerVar &other)
+{
+	if (this != &other)
+		assign(other.limbs, other.used);
+	return *this;
+}
+
+/*
+ * Move assignment: the block of other is taken over if both use the
+ * same arena, otherwise the words are copied
+ */
+BigIntegerVar& BigIntegerVar::operator = (BigIntegerVar &&other)
+{
+	if (this == &other)
+		return *this;
+	if (other.isInline() || other.arena != arena) {
+		assign(other.limbs, other.used);
+	} else {
+		adopt(other.limbs, other.capacity);
+		used = other.used;
+		other.limbs = other.inlineWords;
+		other.capacity = BIG_INTEGER_VAR_INLINE_WORDS;
+	}
+	other.used = 0;
+	return *this;
+}
+
+/*
+ * Destructor: gives the block back to the arena
+ */
+BigIntegerVar::~BigIntegerVar(void)
+{
+	if (!isInline())
+		arena->release(limbs, capacity);
+}
+
+//---------------------------------------------------------------
+/*
+ * Makes room for the given number of words. A new block keeps the
+ * words in use, the old block goes back to the arena.
+ */
+void BigIntegerVar::reserve(int words)
+{
+	if (words <= capacity)
+		return;
+	int size = words;
+	bigIntType *block = arena->allocate(size);
+	for (int i=0; i<used; i++)
+		block[i] = limbs[i];
+	adopt(block, size);
+}
+
+/*
+ * Replaces limbs by a block of size words of the arena, the old
+ * block is given back. used is not changed.
+ */
+void BigIntegerVar::adopt(bigIntType *block, int size)
+{
+	if (!isInline())
+		arena->release(limbs, capacity);
+	limbs = block;
+	capacity = size;
+}
+
+void BigIntegerVar::assign(const bigIntType x[], int n)
+{
+	used = 0;
+	reserve(n);
+	for (int i=0; i<n; i++)
+		limbs[i] = x[i];
+	used = n;
+	normalize();
+}
+
+void BigIntegerVar::normalize()
+{
+	while (used > 0 && limbs[used-1] == 0)
+		used--;
+}
+
+//---------------------------------------------------------------
+/*
+ * Sets *this to the value of a hexadecimal string, see
+ * bigIntegerParseHex(). The string must only hold hex digits.
+ */
+BigIntegerVar& BigIntegerVar::fromHex(std::string_view str)
+{
+	const int n = (int)((str.size() + BIG_INTEGER_NUM_NIBBLES - 1) / BIG_INTEGER_NUM_NIBBLES);
+	used = 0;
+	reserve(n);
+	bigIntegerParseHex(limbs, n, str);
+	used = n;
+	normalize();
+	return *this;
+}
+
+/*
+ * Writes *this as hexadecimal string without leading zeros, zero is
+ * written as "0". No terminating zero is written.
+ * @return pointer behind the last written character
+ */
+char *BigIntegerVar::toHex(char *buf) const
+{
+	return bigIntegerFormatHex(buf, limbs, used, false);
+}
+
+/*
+ * Sets *this to the value of a decimal string, see
+ * bigIntegerParseDecimal(). The string must only hold decimal digits.
+ */
+BigIntegerVar& BigIntegerVar::fromDecimal(std::string_view str)
+{
+	const int n = (int)(str.size() / 19 + 1);		// 10^19 < 2^64
+	used = 0;
+	reserve(n);
+	bigIntegerParseDecimal(limbs, n, str);
+	used = n;
+	normalize();
+	return *this;
+}
+
+/*
+ * Number of characters toDecimal() may write: the digits of used
+ * words (log10(2) = 0.30103) and the rest of the last 19-digit chunk
+ */
+int BigIntegerVar::decimalChars() const
+{
+	return (int)(((long long)used * BIG_INTEGER_WORD_BITS * 30103) / 100000) + 1 + 18;
+}
+
+/*
+ * Writes *this as decimal string without leading zeros, see
+ * bigIntegerFormatDecimal(). The conversion destroys its input, so
+ * it works on a copy, inline or in a block of the arena.
+ * buf needs decimalChars() characters, no terminating zero is written.
+ * @return pointer behind the last written character
+ */
+char *BigIntegerVar::toDecimal(char *buf) const
+{
+	bigIntType local[BIG_INTEGER_VAR_INLINE_WORDS];
+	int size = used;
+	bigIntType *x = (used <= BIG_INTEGER_VAR_INLINE_WORDS) ? local : arena->allocate(size);
+	for (int i=0; i<used; i++)
+		x[i] = limbs[i];
+	buf = bigIntegerFormatDecimal(buf, x, used);
+	if (x != local)
+		arena->release(x, size);
+	return buf;
+}
+
+//---------------------------------------------------------------
+/*
+ * Adds a given BigIntegerVar to *this
+ * The shorter value is zero-extended, the carry out of the top word
+ * adds a word.
+ */
+BigIntegerVar& BigIntegerVar::add(const BigIntegerVar &addend)
+{
+	const int n = (used > addend.used) ? used : addend.used;
+	reserve(n);
+	for (int i=used; i<n; i++)
+		limbs[i] = 0;
+	used = n;
+	bigIntType carry = bigIntegerAddWords(limbs, addend.limbs, addend.used);
+	for (int i=addend.used; carry && i<n; i++)
+		carry = (++limbs[i] == 0);
+	if (carry) {
+		reserve(n + 1);
+		limbs[n] = 1;
+		used = n + 1;
+	}
+	return *this;
+}
+
+/*
+ * Subtracts a given BigIntegerVar from *this
+ * The value has no sign: a subtrahend larger than *this gives the
+ * absolute difference subtrahend - *this.
+ */
+BigIntegerVar& BigIntegerVar::sub(const BigIntegerVar &subtrahend)
+{
+	if (compareTo(subtrahend) < 0) {
+		BigIntegerVar difference(*arena);
+		difference = subtrahend;
+		difference.sub(*this);
+		return *this = std::move(difference);
+	}
+	bigIntType borrow = bigIntegerSubWords(limbs, subtrahend.limbs, subtrahend.used);
+	for (int i=subtrahend.used; borrow && i<used; i++)
+		borrow = (limbs[i]-- == 0);
+	normalize();
+	return *this;
+}
+
+/*
+ * Multiplies *this by a given BigIntegerVar, schoolbook product of
+ * bigIntegerMulWords(). A product of up to
+ * BIG_INTEGER_VAR_INLINE_WORDS words is built on the stack, a longer
+ * one in a new block of the arena, which replaces the old one.
+ */
+BigIntegerVar& BigIntegerVar::mul(const BigIntegerVar &factor)
+{
+	if (used == 0 || factor.used == 0) {
+		used = 0;
+		return *this;
+	}
+	const int n = used + factor.used;
+	if (n <= BIG_INTEGER_VAR_INLINE_WORDS) {
+		bigIntType product[BIG_INTEGER_VAR_INLINE_WORDS];
+		bigIntegerMulWords(product, limbs, used, factor.limbs, factor.used);
+		for (int i=0; i<n; i++)
+			limbs[i] = product[i];
+	} else {
+		int size = n;
+		bigIntType *block = arena->allocate(size);
+		bigIntegerMulWords(block, limbs, used, factor.limbs, factor.used);
+		adopt(block, size);
+	}
+	used = n;
+	normalize();
+	return *this;
+}
+
+/*
+ * Divides *this by a given BigIntegerVar
+ * A one-word divisor takes bigIntegerDivWord(), longer ones Knuth's
+ * algorithm D of bigIntegerDivWords() with quotient, remainder and
+ * scratch in one temporary block of the arena. A zero divisor gives
+ * quotient 0 and *this as remainder.
+ * @param remainder gets *this mod divisor, another instance than
+ *	*this, it may be the divisor
+ * @return *this, the quotient
+ */
+BigIntegerVar& BigIntegerVar::divmod(const BigIntegerVar &divisor, BigIntegerVar &remainder)
+{
+	if (divisor.used == 0 || compareTo(divisor) < 0) {
+		remainder = *this;
+		used = 0;
+		return *this;
+	}
+	if (divisor.used == 1) {
+		bigIntType r = bigIntegerDivWord(limbs, used, divisor.limbs[0]);
+		normalize();
+		remainder = BigIntegerVar(r, *remainder.arena);
+		return *this;
+	}
+	const int m = used, n = divisor.used;
+	int size = (m - n + 1) + n + (m + n + 1);
+	bigIntType *block = arena->allocate(size);
+	bigIntType *q = block, *r = block + (m - n + 1);
+	bigIntegerDivWords(q, r, limbs, m, divisor.limbs, n, r + n);
+	remainder.assign(r, n);
+	for (int i=0; i<m-n+1; i++)
+		limbs[i] = q[i];
+	used = m - n + 1;
+	normalize();
+	arena->release(block, size);
+	return *this;
+}
+
+/*
+ * Reduces *this modulo a given BigIntegerVar, see divmod()
+ */
+BigIntegerVar& BigIntegerVar::mod(const BigIntegerVar &modulus)
+{
+	BigIntegerVar remainder(*arena);
+	divmod(modulus, remainder);
+	return *this = std::move(remainder);
+}
+
+//---------------------------------------------------------------
+/*
+ * Shifts *this to the left, the value grows by the shifted-out bits.
+ * The words are built from the top down with funnel shifts, so the
+ * shift works in place.
+ */
+BigIntegerVar& BigIntegerVar::shiftLeft(unsigned int val)
+{
+	if (used == 0)
+		return *this;
+	const int wordShift = (int)(val / BIG_INTEGER_WORD_BITS);
+	const unsigned int bitShift = val % BIG_INTEGER_WORD_BITS;
+	const int n = (int)((bitLength() + val + BIG_INTEGER_WORD_BITS - 1) / BIG_INTEGER_WORD_BITS);
+	reserve(n);
+	for (int i=n-1; i>=wordShift; i--) {
+		const int j = i - wordShift;
+		bigIntType hi = (j < used) ? limbs[j] : 0;
+		bigIntType lo = (j > 0) ? limbs[j-1] : 0;
+		limbs[i] = bigIntegerFunnelLeft(hi, lo, bitShift);
+	}
+	for (int i=0; i<wordShift; i++)
+		limbs[i] = 0;
+	used = n;
+	normalize();
+	return *this;
+}
+
+/*
+ * Shifts *this to the right, the shifted-out bits are dropped
+ */
+BigIntegerVar& BigIntegerVar::shiftRight(unsigned int val)
+{
+	const int wordShift = (int)(val / BIG_INTEGER_WORD_BITS);
+	const unsigned int bitShift = val % BIG_INTEGER_WORD_BITS;
+	if (wordShift >= used) {
+		used = 0;
+		return *this;
+	}
+	const int n = used - wordShift;
+	for (int i=0; i<n; i++) {
+		bigIntType hi = (i + wordShift + 1 < used) ? limbs[i + wordShift + 1] : 0;
+		limbs[i] = bigIntegerFunnelRight(hi, limbs[i + wordShift], bitShift);
+	}
+	used = n;
+	normalize();
+	return *this;
+}
+
+/*
+ * Position of the highest set bit + 1, 0 for zero
+ */
+int BigIntegerVar::bitLength() const
+{
+	if (used == 0)
+		return 0;
+	return used * BIG_INTEGER_WORD_BITS - __builtin_clzll(limbs[used-1]);
+}
+
+bool BigIntegerVar::testBit(unsigned int n) const
+{
+	const unsigned int word = n / BIG_INTEGER_WORD_BITS;
+	return word < (unsigned int)used && ((limbs[word] >> (n % BIG_INTEGER_WORD_BITS)) & 1);
+}
+
+/*
+ * Compares two BigIntegerVar instances, see bigIntegerEqualWords()
+ * @return true if both are equal
+ */
+bool BigIntegerVar::compare(const BigIntegerVar &testme) const
+{
+	return used == testme.used && bigIntegerEqualWords(limbs, testme.limbs, used);
+}
+
+/*
+ * Three-way comparison: the longer value is larger, values of the
+ * same length are compared from the top word down
+ * @return -1, 0 or 1 for *this below, equal to or above other
+ */
+int BigIntegerVar::compareTo(const BigIntegerVar &other) const
+{
+	if (used != other.used)
+		return (used < other.used) ? -1 : 1;
+	for (int i=used-1; i>=0; i--)
+		if (limbs[i] != other.limbs[i])
+			return (limbs[i] < other.limbs[i]) ? -1 : 1;
+	return 0;
+}
+
+//---------------------------------------------------------------
+/*
+ * controls the output of a BigIntegerVar instance
+ * The value is written in hexadecimal without leading zeros.
+ */
+ostream& operator << (ostream& outstr, const BigIntegerVar &bigint)
+{
+	std::string buf((bigint.used + 1) * BIG_INTEGER_NUM_NIBBLES, '\0');
+	outstr.write(&buf[0], bigint.toHex(&buf[0]) - &buf[0]);
+	return outstr;
+}
@@ -0,0 +1,104 @@
+#ifndef __BIG_INTEGER_VAR_H_
+#define __BIG_INTEGER_VAR_H_
+
+#include "BigInteger.h"
+#include "BigIntegerArena.h"
+
+// Words held inside the instance, 384 bits need no arena block
+#define BIG_INTEGER_VAR_INLINE_WORDS 6
+
+class BigIntegerVar;
+ostream& operator << (ostream&, const BigIntegerVar &);
+
+//---------------------------------------------------------------
+/*
+ * Unsigned integer of variable length
+ * The value grows with the results instead of being cut at a fixed
+ * width: a carry out of the top word of add() or shiftLeft() adds a
+ * word, mul() keeps the full product. Up to
+ * BIG_INTEGER_VAR_INLINE_WORDS words live in inlineWords[], so 192
+ * and 384-bit values never allocate. Longer values move to a block
+ * of a BigIntegerArena, temporaries of mul() and divmod() are taken
+ * from the same arena and given back right away, so a loop of 2048
+ * or 4096-bit operations runs on recycled blocks without malloc.
+ * A block is kept when the value shrinks again. The arithmetic runs
+ * on the word-array kernels shared with BigInteger, see
+ * bigIntegerAddWords() and the following in BigInteger.h.
+ * An instance has to be destroyed before its arena, which is the
+ * one of the creating thread by default, copies included. A value in
+ * static storage therefore has to stay inline or use an arena of its
+ * own. The arena is not synchronized: a value that uses it must be
+ * changed and destroyed on the thread owning the arena only, other
+ * threads may only read and copy it while it does not change.
+ */
+class BigIntegerVar
+{
+	friend ostream& operator << (ostream&, const BigIntegerVar &);
+private:
+	bigIntType *limbs;							// inlineWords[] or an arena block
+	int used;									// words in use, the top one is not zero
+	int capacity;								// words at limbs
+	BigIntegerArena *arena;						// source of the blocks
+	bigIntType inlineWords[BIG_INTEGER_VAR_INLINE_WORDS];
+
+	void reserve(int words);					// room for words, the value is kept
+	void adopt(bigIntType *block, int size);	// replaces limbs by a block of the arena
+	void assign(const bigIntType x[], int n);	// *this = the n words of x
+	void normalize();							// drops zero words at the top
+public:
+	explicit BigIntegerVar(BigIntegerArena &arena = BigIntegerArena::local());	// constructor, zero
+	BigIntegerVar(bigIntType val, BigIntegerArena &arena = BigIntegerArena::local());	// constructor from long
+	BigIntegerVar(const char str[], BigIntegerArena &arena = BigIntegerArena::local());	// constructor from hex string
+	template <unsigned int Bits>
+	explicit BigIntegerVar(const BigInteger<Bits> &x, BigIntegerArena &arena = BigIntegerArena::local());	// from fixed width
+	BigIntegerVar(const BigIntegerVar &other);	// copy constructor, arena of the calling thread
+	BigIntegerVar(BigIntegerVar &&other);		// move constructor, takes over the block
+	BigIntegerVar& operator = (const BigIntegerVar &other);
+	BigIntegerVar& operator = (BigIntegerVar &&other);
+	~BigIntegerVar(void);						// destructor, gives the block back
+	template <unsigned int Bits>
+	BigInteger<Bits> toBigInteger() const;		// lower Bits of the value
+	int words() const { return used; }			// words in use, 0 for zero
+	bool isInline() const { return limbs == inlineWords; }	// no arena block?
+	int decimalChars() const;					// room toDecimal() needs
+	BigIntegerVar& fromHex(std::string_view str);	// set from hexadecimal string
+	char *toHex(char *buf) const;				// write hexadecimal, 16 * words() characters at most
+	BigIntegerVar& fromDecimal(std::string_view str);	// set from decimal string
+	char *toDecimal(char *buf) const;			// write decimal string
+	BigIntegerVar& add(const BigIntegerVar &addend);	// addition
+	BigIntegerVar& sub(const BigIntegerVar &subtrahend);	// absolute difference
+	BigIntegerVar& mul(const BigIntegerVar &factor);	// multiplication
+	BigIntegerVar& divmod(const BigIntegerVar &divisor, BigIntegerVar &remainder);	// *this = quotient
+	BigIntegerVar& mod(const BigIntegerVar &modulus);	// remainder
+	BigIntegerVar& shiftLeft(unsigned int val);	// shift-left, grows
+	BigIntegerVar& shiftRight(unsigned int val);	// shift-right
+	int bitLength() const;						// position of the highest set bit + 1, 0 for 0
+	bool testBit(unsigned int n) const;			// bit n set?
+	bool compare(const BigIntegerVar &testme) const;	// equality
+	int compareTo(const BigIntegerVar &other) const;	// three-way comparison: -1, 0, 1
+};
+
+//---------------------------------------------------------------
+/*
+ * Constructor: from a BigInteger of any width
+ */
+template <unsigned int Bits>
+BigIntegerVar::BigIntegerVar(const BigInteger<Bits> &x, BigIntegerArena &arena)
+	: limbs(inlineWords), used(0), capacity(BIG_INTEGER_VAR_INLINE_WORDS), arena(&arena)
+{
+	assign(x.value, BigInteger<Bits>::WORDS);
+}
+
+/*
+ * Converts to a BigInteger, the words above its width are dropped
+ */
+template <unsigned int Bits>
+BigInteger<Bits> BigIntegerVar::toBigInteger() const
+{
+	BigInteger<Bits> x;
+	for (int i=0; i<BigInteger<Bits>::WORDS && i<used; i++)
+		x.value[i] = limbs[i];
+	return x;
+}
+
+#endif	// __BIG_INTEGER_VAR_H_
@@ -0,0 +1,48 @@
+#ifndef __BIG_INTEGER_VIEW_H_
+#define __BIG_INTEGER_VIEW_H_
+
+#include <type_traits>
+#include "BigInteger.h"
+
+//---------------------------------------------------------------
+/*
+ * Non-owning view of a BigInteger<Bits> in caller-owned memory
+ * BigInteger<Bits> is nothing but its value[] array, so BYTES bytes
+ * holding the words least significant first in host byte order can
+ * be worked on in place: the little-endian binary format of toBytes()
+ * on a little-endian host, e.g. records in an mmap'd file or a packet
+ * buffer. The operations run the BigInteger kernels directly on that
+ * memory, nothing is parsed or copied. The memory has to stay valid
+ * as long as the view is used and be aligned to 8 bytes. Data in
+ * another byte order has to go through fromBytes().
+ */
+template <unsigned int Bits = BIG_INTEGER_DEFAULT_BITS>
+class BigIntegerView
+{
+	static_assert(sizeof(BigInteger<Bits>) == BigInteger<Bits>::BYTES && std::is_standard_layout<BigInteger<Bits> >::value,
+	              "BigInteger<Bits> has to consist of value[] only");
+private:
+	BigInteger<Bits> *limbs;					// the caller's memory
+public:
+	// Number of bytes the view covers
+	static const int BYTES = BigInteger<Bits>::BYTES;
+
+	explicit BigIntegerView(void *buf) : limbs(static_cast<BigInteger<Bits> *>(buf)) {}	// view of BYTES bytes at buf
+	void *data() const { return limbs; }		// the viewed memory
+	BigInteger<Bits>& value() const { return *limbs; }	// the viewed value for all other operations
+
+	BigIntegerView& add(const BigInteger<Bits> &addend) { limbs->add(addend); return *this; }
+	BigIntegerView& addc(const BigInteger<Bits> &addend) { limbs->addc(addend); return *this; }
+	BigIntegerView& adda(const BigInteger<Bits> &addend) { limbs->adda(addend); return *this; }
+	BigIntegerView& add(const BigIntegerView &addend) { limbs->add(*addend.limbs); return *this; }
+	BigIntegerView& addc(const BigIntegerView &addend) { limbs->addc(*addend.limbs); return *this; }
+	BigIntegerView& adda(const BigIntegerView &addend) { limbs->adda(*addend.limbs); return *this; }
+	BigIntegerView& shiftLeft(unsigned int val) { limbs->shiftLeft(val); return *this; }
+	BigIntegerView& modp192() { limbs->modp192(); return *this; }
+	BigIntegerView& modp192c() { limbs->modp192c(); return *this; }
+	BigIntegerView& modp192a() { limbs->modp192a(); return *this; }
+	bool compare(const BigInteger<Bits> &testme) const { return limbs->compare(testme); }
+	bool compare(const BigIntegerView &testme) const { return limbs->compare(*testme.limbs); }
+};
+
+#endif	// __BIG_INTEGER_VIEW_H_
@@ -0,0 +1,54 @@
+#include <iostream>
+	using std::cerr;
+	using std::endl;
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "BigIntegerBulk.h"
+#include "BigIntegerStats.h"
+
+/*
+ * bulk_reduce: reduces a file of hex values mod p192
+ *
+ * usage: bulk_reduce [-t threads] [-v] input [output]
+ *	input and output may be "-" for stdin and stdout,
+ *	output defaults to stdout, -v prints counts and, in a build with
+ *	make STATS=1, the statistics of the operations to stderr.
+ *	An invalid line stops it with exit status 1 and its byte offset.
+ */
+int main(int argc, char* argv[])
+{
+	unsigned int threads = 0;
+	bool verbose = false;
+	const char *input = 0, *output = "-";
+	for (int i=1; i<argc; i++) {
+		if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+			threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-v") == 0)
+			verbose = true;
+		else if (!input)
+			input = argv[i];
+		else
+			output = argv[i];
+	}
+	if (!input) {
+		cerr << "usage: bulk_reduce [-t threads] [-v] input [output]" << endl;
+		return 2;
+	}
+
+	bigIntegerBulkStats stats;
+	if (!bigIntegerBulkReduceFile(input, output, threads, &stats)) {
+		if (errno == EINVAL)
+			cerr << "bulk_reduce: invalid value in the line at byte " << stats.invalidOffset
+			     << ", expected up to 96 hex digits" << endl;
+		else
+			cerr << "bulk_reduce: " << strerror(errno) << endl;
+		return 1;
+	}
+	if (verbose)
+		cerr << "bulk_reduce: " << stats.values << " values, " << stats.chunks << " chunks, "
+		     << stats.threads << " threads" << endl;
+	if (verbose && bigIntegerStatsEnabled())
+		bigIntegerStatsDump(cerr);
+	return 0;
+}
@@ -0,0 +1,550 @@
+#include "P192Point.h"
+#include <thread>
+
+typedef BigInteger<192> fieldElement;
+
+//---------------------------------------------------------------
+/*
+ * Field arithmetic mod p192 on copies, for readable formulas
+ */
+static inline fieldElement fmul(fieldElement a, const fieldElement &b) { return a.mulmod192(b); }
+static inline fieldElement fsqr(fieldElement a) { return a.sqrmod192(); }
+static inline fieldElement fadd(fieldElement a, const fieldElement &b) { return a.addmod192(b); }
+static inline fieldElement fsub(fieldElement a, const fieldElement &b) { return a.submod192(b); }
+static inline bool fzero(const fieldElement &a) { return a.compare(fieldElement()); }
+
+/*
+ * Curve constants, see FIPS 186-4 D.1.2.1, built at compile time
+ */
+static constexpr fieldElement CurveB(0x64210519E59C80E70FA7E9AB72243049FEB8DEECC146B9B1_big);
+static constexpr fieldElement GeneratorX(0x188DA80EB03090F67CBF20EB43A18800F4FF0AFD82FF1012_big);
+static constexpr fieldElement GeneratorY(0x07192B95FFC8DA78631011ED6B24CDD573F977A11E794811_big);
+static constexpr fieldElement GroupOrder(0xFFFFFFFFFFFFFFFFFFFFFFFF99DEF836146BC9B1B4D22831_big);
+
+P192Point P192Point::generator()
+{
+	return P192Point(GeneratorX, GeneratorY);
+}
+
+BigInteger<192> P192Point::order()
+{
+	return GroupOrder;
+}
+
+//---------------------------------------------------------------
+/*
+ * Constructor
+ * The default point is the point at infinity (Z = 0)
+ */
+P192Point::P192Point(void)
+{
+	Y = fieldElement(1);
+}
+
+/*
+ * Constructor: from affine coordinates, Z = 1
+ * The coordinates are reduced mod p192, they are not checked
+ * against the curve equation (see isOnCurve()).
+ */
+P192Point::P192Point(const BigInteger<192> &x, const BigInteger<192> &y)
+{
+	X = x; X.modp192();
+	Y = y; Y.modp192();
+	Z = fieldElement(1);
+}
+
+bool P192Point::isInfinity() const
+{
+	return fzero(Z);
+}
+
+/*
+ * Checks y^2 = x^3 - 3x + b in Jacobian form:
+ * Y^2 = X^3 - 3 X Z^4 + b Z^6
+ */
+bool P192Point::isOnCurve() const
+{
+	if (isInfinity())
+		return true;
+	fieldElement z2 = fsqr(Z), z4 = fsqr(z2), z6 = fmul(z4, z2);
+	fieldElement xz4 = fmul(X, z4);
+	fieldElement rhs = fmul(fsqr(X), X);
+	rhs = fsub(rhs, fadd(fadd(xz4, xz4), xz4));
+	rhs = fadd(rhs, fmul(CurveB, z6));
+	return fsqr(Y).compare(rhs);
+}
+
+/*
+ * Two Jacobian points are equal if X1 Z2^2 = X2 Z1^2 and
+ * Y1 Z2^3 = Y2 Z1^3
+ */
+bool P192Point::equals(const P192Point &other) const
+{
+	if (isInfinity() || other.isInfinity())
+		return isInfinity() && other.isInfinity();
+	fieldElement z1z1 = fsqr(Z), z2z2 = fsqr(other.Z);
+	if (!fmul(X, z2z2).compare(fmul(other.X, z1z1)))
+		return false;
+	return fmul(Y, fmul(z2z2, other.Z)).compare(fmul(other.Y, fmul(z1z1, Z)));
+}
+
+/*
+ * Affine coordinates x = X/Z^2, y = Y/Z^3 with one field inversion.
+ * The point at infinity gives (0,0).
+ */
+void P192Point::toAffine(BigInteger<192> &x, BigInteger<192> &y) const
+{
+	fieldElement zinv = Z;
+	zinv.invmod192();
+	fieldElement zinv2 = fsqr(zinv);
+	x = fmul(X, zinv2);
+	y = fmul(Y, fmul(zinv2, zinv));
+}
+
+/*
+ * Compressed encoding of SEC 1, 2.3.3: the byte 02 for an even and
+ * 03 for an odd y, then x as 24 bytes, most significant first. The
+ * point at infinity is the single byte 00.
+ * @param buf room for P192_COMPRESSED_BYTES bytes
+ * @return pointer behind the last written byte
+ */
+unsigned char *P192Point::toCompressed(unsigned char buf[]) const
+{
+	if (isInfinity()) {
+		buf[0] = 0x00;
+		return buf + 1;
+	}
+	fieldElement x, y;
+	toAffine(x, y);
+	buf[0] = 0x02 | (y.testBit(0) ? 1 : 0);
+	return x.toBytes(buf + 1, BIG_INTEGER_BIG_ENDIAN);
+}
+
+/*
+ * Decodes the compressed encoding, see toCompressed(). y is the
+ * square root of x^3 - 3x + b whose parity the first byte gives,
+ * the other root is p - y.
+ * @param size bytes in buf, P192_COMPRESSED_BYTES or 1 for the point
+ *	at infinity
+ * @return false if the encoding is malformed, x is not below p or
+ *	x^3 - 3x + b is not a square; *this is not changed then
+ */
+bool P192Point::fromCompressed(const unsigned char buf[], size_t size)
+{
+	if (size == 1 && buf[0] == 0x00) {
+		*this = P192Point();
+		return true;
+	}
+	if (size != P192_COMPRESSED_BYTES || (buf[0] != 0x02 && buf[0] != 0x03))
+		return false;
+	fieldElement x;
+	x.fromBytes(buf + 1, BIG_INTEGER_BIG_ENDIAN);
+	static constexpr fieldElement p(0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFFFFFFFFFF_big);
+	if (x >= p)
+		return false;
+
+	fieldElement rhs = fmul(fsqr(x), x);
+	rhs = fsub(rhs, fadd(fadd(x, x), x));
+	rhs = fadd(rhs, CurveB);
+	fieldElement y = rhs;
+	y.sqrtmod192();
+	if (!fsqr(y).compare(rhs))
+		return false;
+	if (y.testBit(0) != (buf[0] == 0x03)) {
+		if (fzero(y))
+			return false;						// y = 0 has no odd root
+		y = fsub(fieldElement(), y);
+	}
+	X = x;
+	Y = y;
+	Z = fieldElement(1);
+	return true;
+}
+
+//---------------------------------------------------------------
+/*
+ * -P = (X, -Y, Z)
+ */
+P192Point& P192Point::negate()
+{
+	Y = fsub(fieldElement(), Y);
+	return *this;
+}
+
+/*
+ * Point doubling for a = -3 (dbl-2001-b), 3M + 5S:
+ *	delta = Z^2, gamma = Y^2, beta = X gamma
+ *	alpha = 3 (X - delta)(X + delta)
+ *	X3 = alpha^2 - 8 beta
+ *	Z3 = (Y + Z)^2 - gamma - delta
+ *	Y3 = alpha (4 beta - X3) - 8 gamma^2
+ * The point at infinity stays at infinity (Z3 = 0).
+ */
+P192Point& P192Point::dbl()
+{
+	fieldElement delta = fsqr(Z);
+	fieldElement gamma = fsqr(Y);
+	fieldElement beta = fmul(X, gamma);
+	fieldElement alpha = fmul(fsub(X, delta), fadd(X, delta));
+	alpha = fadd(fadd(alpha, alpha), alpha);
+	fieldElement beta4 = fadd(beta, beta);
+	beta4 = fadd(beta4, beta4);
+	fieldElement gamma8 = fsqr(gamma);
+	gamma8 = fadd(gamma8, gamma8);
+	gamma8 = fadd(gamma8, gamma8);
+	gamma8 = fadd(gamma8, gamma8);
+
+	Z = fsub(fsub(fsqr(fadd(Y, Z)), gamma), delta);
+	X = fsub(fsqr(alpha), fadd(beta4, beta4));
+	Y = fsub(fmul(alpha, fsub(beta4, X)), gamma8);
+	return *this;
+}
+
+/*
+ * Point addition in Jacobian coordinates (add-2007-bl), 11M + 5S:
+ *	U1 = X1 Z2^2, U2 = X2 Z1^2, S1 = Y1 Z2^3, S2 = Y2 Z1^3
+ *	H = U2 - U1, r = 2 (S2 - S1), I = (2H)^2, J = H I, V = U1 I
+ *	X3 = r^2 - J - 2V
+ *	Y3 = r (V - X3) - 2 S1 J
+ *	Z3 = ((Z1 + Z2)^2 - Z1^2 - Z2^2) H
+ * H = 0 means equal x: the points are equal (doubling) or
+ * negatives of each other (infinity).
+ */
+P192Point& P192Point::add(const P192Point &addend)
+{
+	if (addend.isInfinity())
+		return *this;
+	if (isInfinity())
+		return *this = addend;
+
+	fieldElement z1z1 = fsqr(Z), z2z2 = fsqr(addend.Z);
+	fieldElement u1 = fmul(X, z2z2), u2 = fmul(addend.X, z1z1);
+	fieldElement s1 = fmul(Y, fmul(addend.Z, z2z2)), s2 = fmul(addend.Y, fmul(Z, z1z1));
+	fieldElement h = fsub(u2, u1);
+	fieldElement r = fsub(s2, s1);
+	r = fadd(r, r);
+	if (fzero(h)) {
+		if (fzero(r))
+			return dbl();
+		return *this = P192Point();
+	}
+	fieldElement i = fadd(h, h);
+	i = fsqr(i);
+	fieldElement j = fmul(h, i);
+	fieldElement v = fmul(u1, i);
+	fieldElement s1j = fmul(s1, j);
+
+	Z = fmul(fsub(fsub(fsqr(fadd(Z, addend.Z)), z1z1), z2z2), h);
+	X = fsub(fsub(fsqr(r), j), fadd(v, v));
+	Y = fsub(fmul(r, fsub(v, X)), fadd(s1j, s1j));
+	return *this;
+}
+
+/*
+ * Mixed addition of an affine point (x,y), Z2 = 1 (madd-2007-bl),
+ * 7M + 4S. Same formulas as add() with Z2 = 1:
+ *	U2 = x Z1^2, S2 = y Z1^3, H = U2 - X1, r = 2 (S2 - Y1)
+ *	I = 4 H^2, J = H I, V = X1 I
+ *	Z3 = (Z1 + H)^2 - Z1^2 - H^2
+ */
+P192Point& P192Point::addAffine(const BigInteger<192> &x, const BigInteger<192> &y)
+{
+	if (isInfinity())
+		return *this = P192Point(x, y);
+
+	fieldElement z1z1 = fsqr(Z);
+	fieldElement u2 = fmul(x, z1z1);
+	fieldElement s2 = fmul(y, fmul(Z, z1z1));
+	fieldElement h = fsub(u2, X);
+	fieldElement r = fsub(s2, Y);
+	r = fadd(r, r);
+	if (fzero(h)) {
+		if (fzero(r))
+			return dbl();
+		return *this = P192Point();
+	}
+	fieldElement hh = fsqr(h);
+	fieldElement i = fadd(hh, hh);
+	i = fadd(i, i);
+	fieldElement j = fmul(h, i);
+	fieldElement v = fmul(X, i);
+	fieldElement yj = fmul(Y, j);
+
+	Z = fsub(fsub(fsqr(fadd(Z, h)), z1z1), hh);
+	X = fsub(fsub(fsqr(r), j), fadd(v, v));
+	Y = fsub(fmul(r, fsub(v, X)), fadd(yj, yj));
+	return *this;
+}
+
+//---------------------------------------------------------------
+/*
+ * Converts Jacobian points to affine coordinates with a single
+ * batch inversion of all Z coordinates. None may be at infinity.
+ */
+void P192Point::normalize(const std::vector<P192Point> &points, std::vector<fieldElement> &x, std::vector<fieldElement> &y)
+{
+	std::vector<fieldElement> zinv;
+	for (size_t i=0; i<points.size(); i++)
+		zinv.push_back(points[i].Z);
+	fieldElement::invmod192Batch(&zinv[0], zinv.size());
+	x.resize(points.size());
+	y.resize(points.size());
+	for (size_t i=0; i<points.size(); i++) {
+		fieldElement zinv2 = fsqr(zinv[i]);
+		x[i] = fmul(points[i].X, zinv2);
+		y[i] = fmul(points[i].Y, fmul(zinv2, zinv[i]));
+	}
+}
+
+/*
+ * Variable-base scalar multiplication k * P with a width-w NAF.
+ * The scalar is recoded into digits that are zero or odd and below
+ * 2^(w-1) in magnitude, at most one of w consecutive digits is not
+ * zero. The odd multiples P, 3P, ..., (2^(w-1) - 1)P are computed
+ * once and normalized to affine with one batch inversion, so every
+ * digit costs one mixed addition. Each of the up to 193 digits
+ * costs one doubling.
+ * @param k the scalar, any 192-bit value
+ */
+P192Point& P192Point::mul(const BigInteger<192> &k)
+{
+	const int w = P192_WNAF_WIDTH;
+	const int tableSize = 1 << (w - 2);
+	if (isInfinity())
+		return *this;
+
+	// wNAF recoding of k
+	signed char naf[192 + 1];
+	int len = 0;
+	bigIntType e[4] = {k.value[0], k.value[1], k.value[2], 0};
+	while (e[0] | e[1] | e[2] | e[3]) {
+		int digit = 0;
+		if (e[0] & 1) {
+			digit = (int)(e[0] & ((1 << w) - 1));
+			if (digit >= (1 << (w - 1)))
+				digit -= 1 << w;
+			// e -= digit, a negative digit is added
+			bigIntType d = (digit > 0) ? (bigIntType)digit : (bigIntType)-digit;
+			if (digit > 0) {
+				bigIntType borrow = e[0] < d;
+				e[0] -= d;
+				for (int i=1; i<4; i++) {
+					bigIntType b = e[i] < borrow;
+					e[i] -= borrow;
+					borrow = b;
+				}
+			} else {
+				e[0] += d;
+				bigIntType carry = e[0] < d;
+				for (int i=1; i<4; i++) {
+					e[i] += carry;
+					carry = e[i] < carry;
+				}
+			}
+		}
+		naf[len++] = (signed char)digit;
+		for (int i=0; i<3; i++)
+			e[i] = (e[i] >> 1) | (e[i+1] << 63);
+		e[3] >>= 1;
+	}
+
+	// odd multiples (2i+1) P
+	std::vector<P192Point> table;
+	P192Point twice = *this, multiple = *this;
+	twice.dbl();
+	for (int i=0; i<tableSize; i++) {
+		table.push_back(multiple);
+		multiple.add(twice);
+	}
+	std::vector<fieldElement> tx, ty;
+	normalize(table, tx, ty);
+
+	P192Point q;
+	for (int i=len-1; i>=0; i--) {
+		q.dbl();
+		if (naf[i] > 0)
+			q.addAffine(tx[naf[i] >> 1], ty[naf[i] >> 1]);
+		else if (naf[i] < 0)
+			q.addAffine(tx[(-naf[i]) >> 1], fsub(fieldElement(), ty[(-naf[i]) >> 1]));
+	}
+	return *this = q;
+}
+
+//---------------------------------------------------------------
+/*
+ * Comb table of the generator (Lim-Lee), built on first use.
+ * With t = P192_COMB_TEETH teeth the scalar is cut into t rows of
+ * d = 192 / t bits. Entry j (1 <= j < 2^t) is the sum of 2^(i d) G
+ * over the bits i set in j. The entries are normalized to affine
+ * with one batch inversion; they are never at infinity because G
+ * has prime order n > 2^191. Entry 0 is unused.
+ */
+std::vector<P192Point> P192Point::buildBaseTable()
+{
+	const int t = P192_COMB_TEETH;
+	const int d = (192 + t - 1) / t;
+	std::vector<P192Point> table(1 << t);
+	P192Point row = P192Point::generator();
+	for (int i=0; i<t; i++) {
+		table[1 << i] = row;
+		for (int j=0; j<d; j++)
+			row.dbl();
+	}
+	for (int j=1; j<(1 << t); j++) {
+		if ((j & (j - 1)) == 0)
+			continue;
+		table[j] = table[j & (j - 1)];
+		table[j].add(table[j & -j]);
+	}
+
+	std::vector<P192Point> points(table.begin() + 1, table.end());
+	std::vector<fieldElement> x, y;
+	normalize(points, x, y);
+	for (int j=1; j<(1 << t); j++)
+		table[j] = P192Point(x[j-1], y[j-1]);
+	return table;
+}
+
+const P192Point *P192Point::baseTable()
+{
+	static const std::vector<P192Point> table = buildBaseTable();
+	return &table[0];
+}
+
+/*
+ * Fixed-base scalar multiplication k * G with the comb table.
+ * Column c of the comb collects the bits c, c + d, ..., c + (t-1) d
+ * of k into a table index. The columns are processed from the top,
+ * so there are d = 24 doublings and at most 24 mixed additions.
+ * @param k the scalar, any 192-bit value
+ */
+P192Point P192Point::mulBase(const BigInteger<192> &k)
+{
+	const int t = P192_COMB_TEETH;
+	const int d = (192 + t - 1) / t;
+	const P192Point *table = baseTable();
+
+	P192Point q;
+	for (int col=d-1; col>=0; col--) {
+		q.dbl();
+		int index = 0;
+		for (int i=0; i<t; i++) {
+			int bit = col + i * d;
+			index |= (int)((k.value[bit / 64] >> (bit % 64)) & 1) << i;
+		}
+		if (index)
+			q.addAffine(table[index].X, table[index].Y);
+	}
+	return q;
+}
+
+//---------------------------------------------------------------
+/*
+ * Window size of the bucket method for n points.
+ * With window c the 192-bit scalars give ceil(192 / c) columns. A
+ * column costs n mixed additions into the buckets and about 2^(c+1)
+ * additions to sum the buckets up, all columns together need 192
+ * doublings. The c with the smallest estimated cost is taken.
+ */
+int P192Point::msmWindow(size_t n)
+{
+	int best = 1;
+	double bestCost = 0;
+	for (int c=1; c<=16; c++) {
+		double columns = (192 + c - 1) / c;
+		double cost = columns * ((double)n + 2.0 * (1 << c)) + 192;
+		if (c == 1 || cost < bestCost) {
+			best = c;
+			bestCost = cost;
+		}
+	}
+	return best;
+}
+
+/*
+ * Bucket accumulation of one column of the scalars: the bits
+ * column * window ... column * window + window - 1 of every scalar
+ * select the bucket its point is added to. The buckets are summed
+ * as sum over b of b * bucket[b] with two running sums, from the
+ * highest bucket down.
+ */
+P192Point P192Point::msmColumn(const std::vector<fieldElement> &x, const std::vector<fieldElement> &y,
+                               const std::vector<const fieldElement *> &scalars, int window, int column)
+{
+	std::vector<P192Point> buckets(1 << window);
+	int first = column * window;
+	for (size_t i=0; i<scalars.size(); i++) {
+		int digit = 0;
+		for (int b=0; b<window && first+b<192; b++) {
+			int bit = first + b;
+			digit |= (int)((scalars[i]->value[bit / 64] >> (bit % 64)) & 1) << b;
+		}
+		if (digit)
+			buckets[digit].addAffine(x[i], y[i]);
+	}
+
+	P192Point running, sum;
+	for (int b=(1 << window)-1; b>0; b--) {
+		running.add(buckets[b]);
+		sum.add(running);
+	}
+	return sum;
+}
+
+/*
+ * Multi-scalar multiplication sum k_i * P_i (Pippenger's bucket
+ * method). The points are normalized to affine with one batch
+ * inversion, points at infinity and zero scalars are dropped. The
+ * scalars are cut into columns of msmWindow(n) bits, every column is
+ * accumulated in buckets (msmColumn()), and the column sums are
+ * combined from the top with window doublings in between, so all
+ * points share 192 doublings.
+ * The columns are independent: with threads > 1 (0 = one per
+ * hardware thread) they are distributed over worker threads.
+ * @param points array of n points
+ * @param scalars array of n 192-bit scalars
+ */
+P192Point P192Point::msm(const P192Point points[], const BigInteger<192> scalars[], size_t n, unsigned int threads)
+{
+	std::vector<P192Point> used;
+	std::vector<const fieldElement *> k;
+	for (size_t i=0; i<n; i++) {
+		if (points[i].isInfinity() || fzero(scalars[i]))
+			continue;
+		used.push_back(points[i]);
+		k.push_back(&scalars[i]);
+	}
+	if (used.empty())
+		return P192Point();
+	std::vector<fieldElement> x, y;
+	normalize(used, x, y);
+
+	const int window = msmWindow(used.size());
+	const int columns = (192 + window - 1) / window;
+	std::vector<P192Point> sums(columns);
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads > (unsigned int)columns)
+		threads = columns;
+	if (threads <= 1) {
+		for (int c=0; c<columns; c++)
+			sums[c] = msmColumn(x, y, k, window, c);
+	} else {
+		std::vector<std::thread> pool;
+		for (unsigned int t=0; t<threads; t++)
+			pool.push_back(std::thread([&, t]{
+				for (int c=t; c<columns; c+=threads)
+					sums[c] = msmColumn(x, y, k, window, c);
+			}));
+		for (unsigned int t=0; t<threads; t++)
+			pool[t].join();
+	}
+
+	P192Point result = sums[columns-1];
+	for (int c=columns-2; c>=0; c--) {
+		for (int i=0; i<window; i++)
+			result.dbl();
+		result.add(sums[c]);
+	}
+	return result;
+}
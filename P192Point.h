@@ -0,0 +1,61 @@
+#ifndef __P192_POINT_H_
+#define __P192_POINT_H_
+
+#include <vector>
+#include "BigInteger.h"
+
+// Width of the wNAF recoding of variable-base scalar multiplication
+#define P192_WNAF_WIDTH 5
+
+// Bytes of the compressed encoding (SEC 1): 02 or 03 and x, 24 bytes
+#define P192_COMPRESSED_BYTES 25
+
+// Number of teeth of the fixed-base comb, the table has 2^teeth - 1 points
+#define P192_COMB_TEETH 8
+
+//---------------------------------------------------------------
+/*
+ * Point on the NIST curve P-192: y^2 = x^3 - 3x + b mod p192
+ * The point is held in Jacobian coordinates (X,Y,Z), which stand
+ * for the affine point (X/Z^2, Y/Z^3). Z = 0 is the point at
+ * infinity. All coordinates are fully reduced field elements, the
+ * field arithmetic is done by BigInteger<192>::mulmod192() and its
+ * neighbours.
+ * The arithmetic is not constant-time: the special cases of the
+ * addition and the scalar recoding branch on the data.
+ */
+class P192Point
+{
+private:
+	BigInteger<192> X, Y, Z;
+	P192Point& addAffine(const BigInteger<192> &x, const BigInteger<192> &y);	// mixed addition
+	static std::vector<P192Point> buildBaseTable();
+	static const P192Point *baseTable();		// comb table of the generator
+	static P192Point msmColumn(const std::vector<BigInteger<192> > &x, const std::vector<BigInteger<192> > &y,
+	                           const std::vector<const BigInteger<192> *> &scalars, int window, int column);
+	static void normalize(const std::vector<P192Point> &points,	// affine coordinates of many points
+	                      std::vector<BigInteger<192> > &x, std::vector<BigInteger<192> > &y);
+public:
+	P192Point(void);							// constructor, point at infinity
+	P192Point(const BigInteger<192> &x, const BigInteger<192> &y);	// constructor from affine coordinates
+	static P192Point generator();				// base point G
+	static BigInteger<192> order();				// group order n
+
+	bool isInfinity() const;					// point at infinity?
+	bool isOnCurve() const;						// satisfies the curve equation?
+	bool equals(const P192Point &other) const;	// same point?
+	void toAffine(BigInteger<192> &x, BigInteger<192> &y) const;	// affine coordinates
+	unsigned char *toCompressed(unsigned char buf[]) const;	// SEC 1 compressed encoding
+	bool fromCompressed(const unsigned char buf[], size_t size);	// decodes, false if invalid
+
+	P192Point& negate();						// -P
+	P192Point& dbl();							// 2P
+	P192Point& add(const P192Point &addend);	// P + Q
+	P192Point& mul(const BigInteger<192> &k);	// k * P, wNAF
+	static P192Point mulBase(const BigInteger<192> &k);	// k * G, comb
+	static P192Point msm(const P192Point points[], const BigInteger<192> scalars[],	// sum of k_i * P_i
+	                     size_t n, unsigned int threads = 1);
+	static int msmWindow(size_t n);				// Pippenger window size for n points
+};
+
+#endif	// __P192_POINT_H_